@@ -0,0 +1,274 @@
+#include "AutoPlayer.h"
+#include "Profiler.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+    const int MERGE_TABLE_LOG2 = 14;                   // 16384 buckets, far more than one level ever stores
+    const uint64_t LEVEL_SALT = 0x9E3779B97F4A7C15ull; // Separates the keys of different levels and searches
+}
+
+// Buffers owned by one expanding thread, sized for the largest possible placement list
+struct AutoPlayer::Workspace
+{
+    MoveGenerator generator;
+    BatchEvaluator::Rows rows[MoveGenerator::MAX_PLACEMENTS];
+    BatchEvaluator::Features features[MoveGenerator::MAX_PLACEMENTS];
+    std::vector<Candidate> candidates; // Scored children of the parents this thread expanded
+    long nodes = 0;                    // Placements scored since the last search
+};
+
+// Constructor - one workspace per pool thread (or a single one without a pool)
+AutoPlayer::AutoPlayer(const Settings &settings, ThreadPool *pool)
+    : settings(settings), pool(pool), merged(MERGE_TABLE_LOG2), searches(0), stats(),
+      plannedPiece(-1), target(Tetromino::I), expected(Tetromino::I), pathLength(0), pathNext(0)
+{
+    this->settings.beamWidth = std::max(1, settings.beamWidth);
+    this->settings.depth = std::min(std::max(1, settings.depth), MAX_DEPTH);
+    evaluator.setWeights(settings.weights);
+
+    unsigned threads = pool != nullptr ? std::max(1u, pool->size()) : 1;
+    for (unsigned i = 0; i < threads; ++i)
+        workspaces.emplace_back(new Workspace());
+}
+
+AutoPlayer::~AutoPlayer() {}
+
+// Forget the current plan, the boards and the statistics of the previous game, so every game
+// plays as it would on a new player
+void AutoPlayer::reset(unsigned)
+{
+    forgetPlan();
+    merged.clear();
+    searches = 0;
+    stats = Stats();
+}
+
+// The next call searches again, whatever piece is falling
+void AutoPlayer::forgetPlan()
+{
+    plannedPiece = -1;
+    pathLength = 0;
+    pathNext = 0;
+}
+
+// Searches once per piece, then steers the piece toward the chosen placement frame by frame
+unsigned AutoPlayer::chooseActions(const Engine &engine)
+{
+    if (engine.isGameOver())
+        return 0;
+    if (engine.getPiecesPlaced() != plannedPiece && !search(engine))
+        return Engine::HARD_DROP; // No legal placement: the game is lost whatever we do
+    return steer(engine);
+}
+
+// Beam search over the current piece and the preview; sets target to the best root placement
+bool AutoPlayer::search(const Engine &engine)
+{
+    PROFILE_SCOPE(SEARCH);
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point began = Clock::now();
+    stats.decisions++;
+    searches++;
+
+    beam.clear();
+    beam.push_back({engine.getBoard(), 0, 0, -1});
+
+    // The root is expanded with the steering generator so its placements stay available for paths
+    Workspace &main = *workspaces[0];
+    main.candidates.clear();
+    expand(main, steering, beam[0], 0, engine.getCurrentPiece());
+    candidates.swap(main.candidates);
+
+    for (int level = 0; !candidates.empty(); ++level)
+    {
+        selectBeam(level);
+        beam.swap(nextBeam);
+        if (level + 1 >= settings.depth)
+            break;
+        expandLevel(engine.getNextPiece(level));
+    }
+
+    for (std::unique_ptr<Workspace> &workspace : workspaces)
+    {
+        stats.nodes += workspace->nodes;
+        workspace->nodes = 0;
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - began).count();
+    stats.searchSeconds += seconds;
+    stats.maxDecisionMs = std::max(stats.maxDecisionMs, seconds * 1000);
+
+    if (beam.empty() || beam[0].first < 0)
+        return false; // The current piece has nowhere to go
+
+    // Each level's beam is sorted best first, so beam[0] is the best board of the deepest level reached
+    plannedPiece = engine.getPiecesPlaced();
+    target = steering.getPlacement(beam[0].first);
+    pathLength = 0;
+    pathNext = 0;
+    return true;
+}
+
+// Scores every placement of piece on the parent board and appends them to the workspace
+void AutoPlayer::expand(Workspace &workspace, MoveGenerator &generator, const Node &parent, int parentIndex, const Tetromino &piece)
+{
+    int count = generator.generate(parent.board, piece);
+    for (int i = 0; i < count; ++i)
+        BatchEvaluator::withPiece(parent.board, generator.getPlacement(i), workspace.rows[i]);
+    evaluator.evaluate(workspace.rows, count, workspace.features, nullptr);
+
+    for (int i = 0; i < count; ++i)
+    {
+        BatchEvaluator::Features features = workspace.features[i];
+        int lines = parent.lines + features.completedLines;
+        if (features.completedLines > 0)
+        {
+            // Clearing can uncover holes and lower columns by more than a row, so measure the cleared board
+            Board cleared = parent.board;
+            cleared.placePiece(generator.getPlacement(i));
+            cleared.clearFullLines();
+            features.aggregateHeight = cleared.getAggregateHeight();
+            features.holes = cleared.getHoles();
+            features.bumpiness = cleared.getBumpiness();
+        }
+        features.completedLines = lines;
+        workspace.candidates.push_back({evaluator.score(features), lines, parentIndex, i,
+                                        parent.first < 0 ? i : parent.first, generator.getPlacement(i)});
+    }
+    workspace.nodes += count;
+}
+
+// Expands every board of the beam, spreading the parents over the pool threads
+void AutoPlayer::expandLevel(Tetromino::Type type)
+{
+    int tasks = std::min(static_cast<int>(workspaces.size()), static_cast<int>(beam.size()));
+    auto work = [this, tasks, type](int task)
+    {
+        Workspace &workspace = *workspaces[task];
+        workspace.candidates.clear();
+        for (int i = task; i < static_cast<int>(beam.size()); i += tasks)
+            expand(workspace, workspace.generator, beam[i], i, Tetromino(type));
+    };
+
+    for (int task = 1; task < tasks; ++task)
+        pool->submit([work, task]
+                     { work(task); });
+    work(0); // The calling thread takes the first share
+    if (tasks > 1)
+        pool->wait();
+
+    candidates.clear();
+    for (int task = 0; task < tasks; ++task)
+        candidates.insert(candidates.end(), workspaces[task]->candidates.begin(), workspaces[task]->candidates.end());
+}
+
+// Builds the boards of the best candidates, skipping boards already reached through another order
+void AutoPlayer::selectBeam(int level)
+{
+    // Ties are broken by position, so the beam does not depend on how parents were split over threads
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b)
+              {
+                  if (a.score != b.score)
+                      return a.score > b.score;
+                  return a.parent != b.parent ? a.parent < b.parent : a.placement < b.placement; });
+
+    uint64_t salt = (searches * MAX_DEPTH + static_cast<uint64_t>(level) + 1) * LEVEL_SALT;
+    nextBeam.clear();
+    for (const Candidate &candidate : candidates)
+    {
+        if (static_cast<int>(nextBeam.size()) >= settings.beamWidth)
+            break;
+
+        Node node = {beam[candidate.parent].board, candidate.score, candidate.lines, candidate.first};
+        node.board.placePiece(candidate.piece);
+        node.board.clearFullLines();
+
+        TranspositionTable::Value seen;
+        uint64_t key = node.board.hash() ^ salt;
+        if (merged.probe(key, seen))
+            continue; // A better-scored order already produced this board
+        merged.store(key, {candidate.score, level});
+        nextBeam.push_back(node);
+    }
+}
+
+// Breadth-first inputs from where the piece is now to the target; false if the target is out of reach
+bool AutoPlayer::planPath(const Engine &engine)
+{
+    pathLength = 0;
+    pathNext = 0;
+    steering.generate(engine.getBoard(), engine.getCurrentPiece());
+    int index = steering.find(target);
+    if (index < 0)
+        return false;
+    int length = steering.getPath(index, path, MAX_PATH);
+    if (length < 0)
+        return false;
+
+    // Drops just before the final hard drop do nothing
+    while (length >= 2 && path[length - 2] == Engine::SOFT_DROP)
+        path[--length - 1] = Engine::HARD_DROP;
+    pathLength = length;
+    expected = engine.getCurrentPiece();
+    return true;
+}
+
+// Moves and rotates straight toward the target, one step of each per frame, and hard drops once
+// above it. Targets that need a slide or a tuck, or a piece knocked off course by gravity, fall
+// back to a breadth-first path; a target that can no longer be reached triggers a new search.
+unsigned AutoPlayer::steer(const Engine &engine)
+{
+    const Board &board = engine.getBoard();
+    const Tetromino &piece = engine.getCurrentPiece();
+
+    if (pathLength > 0)
+    {
+        bool onCourse = piece.getX() == expected.getX() && piece.getY() == expected.getY() &&
+                        piece.getRotation() == expected.getRotation();
+        if (!onCourse)
+        {
+            stats.replans++;
+            if (!planPath(engine) && (!search(engine) || !planPath(engine)))
+                return Engine::HARD_DROP;
+        }
+        if (pathNext >= pathLength)
+            return Engine::HARD_DROP;
+
+        unsigned action = path[pathNext++];
+        expected = piece;
+        if (action == Engine::MOVE_LEFT)
+            board.movePiece(expected, -1, 0);
+        else if (action == Engine::MOVE_RIGHT)
+            board.movePiece(expected, 1, 0);
+        else if (action == Engine::SOFT_DROP)
+            board.movePiece(expected, 0, 1);
+        else if (action == Engine::ROTATE)
+            board.rotatePiece(expected);
+        return action;
+    }
+
+    // Simulate this frame in Engine::input order: horizontal move first, then rotation
+    Tetromino next = piece;
+    unsigned actions = 0;
+    if (next.getX() < target.getX() && board.movePiece(next, 1, 0))
+        actions |= Engine::MOVE_RIGHT;
+    else if (next.getX() > target.getX() && board.movePiece(next, -1, 0))
+        actions |= Engine::MOVE_LEFT;
+    if (next.getRotation() != target.getRotation() && board.rotatePiece(next))
+        actions |= Engine::ROTATE;
+
+    if (next.getX() == target.getX() && next.getRotation() == target.getRotation())
+    {
+        if (next.getY() + board.dropDistance(next) == target.getY())
+            return actions | Engine::HARD_DROP;
+    }
+    else if (actions != 0)
+        return actions; // Still closing in
+
+    // Blocked on the way, or the drop would land somewhere else
+    if (!planPath(engine) && (!search(engine) || !planPath(engine)))
+        return Engine::HARD_DROP;
+    return steer(engine);
+}
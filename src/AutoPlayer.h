@@ -0,0 +1,115 @@
+#ifndef AUTO_PLAYER_H
+#define AUTO_PLAYER_H
+
+#include "BatchEvaluator.h"
+#include "MoveGenerator.h"
+#include "Policy.h"
+#include "TranspositionTable.h"
+#include <memory>
+#include <vector>
+
+class ThreadPool;
+
+// AutoPlayer is a beam-search bot. For every new piece it enumerates the placements of the current
+// piece with MoveGenerator, then of each known next piece on the boards that survived the previous
+// level, keeping the best beamWidth boards per level by the BatchEvaluator heuristic. The placement
+// at the root of the best final board is played by steering the piece there with ordinary Engine
+// actions, so the bot obeys exactly the same movement rules as a human player.
+//
+// Children are scored before they are built: BatchEvaluator scores all placements on a parent at
+// once from row masks, and only placements that complete lines get a cleared board to measure.
+// Only the survivors of each level are copied into boards. Boards reached in two different orders
+// are merged through a TranspositionTable. With a ThreadPool, the parents of each level are expanded
+// in parallel; ties are broken by position, so the moves do not depend on the number of threads.
+class AutoPlayer : public Policy
+{
+public:
+    static const int MAX_DEPTH = 1 + Randomizer::PREVIEW; // Current piece plus the whole preview
+
+    // Search settings
+    struct Settings
+    {
+        int beamWidth = 8;               // Boards kept per level
+        int depth = 2;                   // Pieces searched (1 = current piece only, up to MAX_DEPTH)
+        BatchEvaluator::Weights weights; // Heuristic used to rank boards
+    };
+
+    // Search cost since the last reset()
+    struct Stats
+    {
+        long decisions;       // Searches run (one per piece)
+        long nodes;           // Placements evaluated
+        long replans;         // Paths recomputed because gravity or a blocked move changed the piece
+        double searchSeconds; // Time spent searching
+        double maxDecisionMs; // Slowest search
+
+        double nodesPerSecond() const { return searchSeconds > 0 ? nodes / searchSeconds : 0; }
+        double meanDecisionMs() const { return decisions > 0 ? searchSeconds * 1000 / decisions : 0; }
+    };
+
+    explicit AutoPlayer(const Settings &settings, ThreadPool *pool = nullptr); // pool = nullptr searches on the calling thread
+    ~AutoPlayer();
+
+    void reset(unsigned seed) override;
+    unsigned chooseActions(const Engine &engine) override;
+    void forgetPlan(); // Drops the target of the current piece (the game jumped to another position)
+
+    const Settings &getSettings() const { return settings; }
+    const Stats &getStats() const { return stats; }
+
+private:
+    static const int MAX_PATH = 128; // Longest fallback input sequence
+
+    // A board kept in the beam
+    struct Node
+    {
+        Board board;
+        float score; // Heuristic of the board with the lines cleared on the way to it
+        int lines;   // Lines cleared since the root
+        int first;   // Root placement this board descends from (-1 for the root)
+    };
+
+    // A scored placement, not yet turned into a board
+    struct Candidate
+    {
+        float score;
+        int lines;
+        int parent;      // Index of the parent in the beam
+        int placement;   // Index among the parent's placements (breaks score ties)
+        int first;       // Root placement it descends from
+        Tetromino piece; // Piece at rest
+    };
+
+    struct Workspace; // Per-thread generator and buffers
+
+    Settings settings;
+    ThreadPool *pool;
+    BatchEvaluator evaluator;
+    TranspositionTable merged; // Boards already in the next beam
+    uint64_t searches;         // Searches since reset(), for the salt that keeps merged entries of each search apart
+    Stats stats;
+
+    std::vector<std::unique_ptr<Workspace>> workspaces; // One per thread that expands parents
+    std::vector<Node> beam;
+    std::vector<Node> nextBeam;
+    std::vector<Candidate> candidates;
+
+    MoveGenerator steering;  // Placements of the current piece, for the root and for fallback paths
+    long plannedPiece;       // Engine::getPiecesPlaced() when the target was chosen (-1 = none)
+    Tetromino target;        // Where the current piece should come to rest
+    Tetromino expected;      // Where the piece should be after the last returned actions
+    unsigned path[MAX_PATH]; // Fallback inputs for targets that need a slide or a tuck
+    int pathLength;
+    int pathNext;
+
+    bool search(const Engine &engine);      // Picks a target for the current piece
+    void expandLevel(Tetromino::Type type); // Expands every node of the beam (in parallel with a pool)
+    void selectBeam(int level);             // Builds the best distinct candidates into nextBeam
+    bool planPath(const Engine &engine);    // Fallback: BFS inputs from the current piece to the target
+    unsigned steer(const Engine &engine);   // Next actions toward the target
+
+    // Scores every placement of piece on parent into the workspace
+    void expand(Workspace &workspace, MoveGenerator &generator, const Node &parent, int parentIndex, const Tetromino &piece);
+};
+
+#endif
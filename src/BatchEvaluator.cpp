@@ -0,0 +1,349 @@
+#include "BatchEvaluator.h"
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define BATCH_EVALUATOR_X86 1
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    const Board::Row FIELD = Board::FIELD_MASK;
+    const Board::Row PAIRS = static_cast<Board::Row>(Board::FIELD_MASK & (Board::FIELD_MASK >> 1)); // Bit x set when x and x + 1 are both columns
+
+    // Set bits in a row mask
+    inline int popcount16(unsigned v)
+    {
+        v = v - ((v >> 1) & 0x5555u);
+        v = (v & 0x3333u) + ((v >> 2) & 0x3333u);
+        v = (v + (v >> 4)) & 0x0F0Fu;
+        return static_cast<int>((v + (v >> 8)) & 0x1Fu);
+    }
+
+    // Copies up to lanes boards into lane-major order (row y of board i at out[y * lanes + i]);
+    // missing boards are padded with empty rows
+    void transpose(const BatchEvaluator::Rows *boards, int count, int lanes, uint16_t *out)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            for (int y = 0; y < Board::HEIGHT; ++y)
+                out[y * lanes + i] = boards[i].rows[y];
+        }
+        for (int i = count; i < lanes; ++i)
+        {
+            for (int y = 0; y < Board::HEIGHT; ++y)
+                out[y * lanes + i] = Board::EMPTY_ROW;
+        }
+    }
+}
+
+// Constructor - selects the fastest kernel the CPU supports
+BatchEvaluator::BatchEvaluator() : kernel(SCALAR)
+{
+    if (isSupported(AVX2))
+        kernel = AVX2;
+    else if (isSupported(SSSE3))
+        kernel = SSSE3;
+}
+
+// Whether this machine can run a kernel
+bool BatchEvaluator::isSupported(Kernel kernel)
+{
+    switch (kernel)
+    {
+    case SCALAR:
+        return true;
+#ifdef BATCH_EVALUATOR_X86
+    case SSSE3:
+        return __builtin_cpu_supports("ssse3");
+    case AVX2:
+        return __builtin_cpu_supports("avx2");
+#else
+    default:
+        return false;
+#endif
+    }
+    return false;
+}
+
+const char *BatchEvaluator::kernelName(Kernel kernel)
+{
+    switch (kernel)
+    {
+    case SCALAR:
+        return "scalar";
+    case SSSE3:
+        return "ssse3";
+    case AVX2:
+        return "avx2";
+    }
+    return "unknown";
+}
+
+// Forces a kernel (for comparisons); the CPU must support it
+bool BatchEvaluator::setKernel(Kernel newKernel)
+{
+    if (!isSupported(newKernel))
+        return false;
+    kernel = newKernel;
+    return true;
+}
+
+// Features for every board, then scores in a fixed order
+void BatchEvaluator::evaluate(const Rows *boards, int count, Features *features, float *scores) const
+{
+    const int CHUNK = 64;
+    Features local[CHUNK];
+    for (int start = 0; start < count; start += CHUNK)
+    {
+        int n = count - start < CHUNK ? count - start : CHUNK;
+        Features *out = features != nullptr ? features + start : local;
+        runKernel(kernel, boards + start, n, out);
+        if (scores != nullptr)
+        {
+            for (int i = 0; i < n; ++i)
+                scores[start + i] = score(out[i]);
+        }
+    }
+}
+
+// Weighted sum of the features
+float BatchEvaluator::score(const Features &features) const
+{
+    return weights.aggregateHeight * static_cast<float>(features.aggregateHeight) +
+           weights.holes * static_cast<float>(features.holes) +
+           weights.bumpiness * static_cast<float>(features.bumpiness) +
+           weights.completedLines * static_cast<float>(features.completedLines);
+}
+
+void BatchEvaluator::runKernel(Kernel kernel, const Rows *boards, int count, Features *features)
+{
+    switch (kernel)
+    {
+    case AVX2:
+        evaluateAvx2(boards, count, features);
+        break;
+    case SSSE3:
+        evaluateSsse3(boards, count, features);
+        break;
+    default:
+        evaluateScalar(boards, count, features);
+        break;
+    }
+}
+
+// One board at a time, with the same row recurrences as the vector kernels
+void BatchEvaluator::evaluateScalar(const Rows *boards, int count, Features *features)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        unsigned seen = 0;
+        Features result = {0, 0, 0, 0};
+        for (int y = 0; y < Board::HEIGHT; ++y)
+        {
+            unsigned row = boards[i].rows[y] & FIELD;
+            seen |= row;
+            result.aggregateHeight += popcount16(seen);
+            result.holes += popcount16(seen & ~row);
+            result.bumpiness += popcount16((seen ^ (seen >> 1)) & PAIRS);
+            result.completedLines += row == FIELD;
+        }
+        features[i] = result;
+    }
+}
+
+#ifdef BATCH_EVALUATOR_X86
+namespace
+{
+    // Per-lane popcount of 16-bit lanes: nibble lookup with pshufb, then the two bytes of each lane added
+    __attribute__((target("ssse3"))) inline __m128i popcount16x8(__m128i v)
+    {
+        const __m128i lut = _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+        const __m128i low4 = _mm_set1_epi8(0x0F);
+        __m128i counts = _mm_add_epi8(_mm_shuffle_epi8(lut, _mm_and_si128(v, low4)),
+                                      _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(v, 4), low4)));
+        return _mm_add_epi16(_mm_and_si128(counts, _mm_set1_epi16(0x00FF)), _mm_srli_epi16(counts, 8));
+    }
+
+    __attribute__((target("avx2"))) inline __m256i popcount16x16(__m256i v)
+    {
+        const __m256i lut = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                             0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+        const __m256i low4 = _mm256_set1_epi8(0x0F);
+        __m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(lut, _mm256_and_si256(v, low4)),
+                                         _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(v, 4), low4)));
+        return _mm256_add_epi16(_mm256_and_si256(counts, _mm256_set1_epi16(0x00FF)), _mm256_srli_epi16(counts, 8));
+    }
+}
+
+// Eight boards per iteration, one per 16-bit lane
+__attribute__((target("ssse3"))) void BatchEvaluator::evaluateSsse3(const Rows *boards, int count, Features *features)
+{
+    const int LANES = 8;
+    alignas(16) uint16_t lanes[Board::HEIGHT * LANES];
+    alignas(16) uint16_t totals[4][LANES];
+    const __m128i field = _mm_set1_epi16(static_cast<short>(FIELD));
+    const __m128i pairs = _mm_set1_epi16(static_cast<short>(PAIRS));
+
+    for (int start = 0; start < count; start += LANES)
+    {
+        int n = count - start < LANES ? count - start : LANES;
+        transpose(boards + start, n, LANES, lanes);
+
+        __m128i seen = _mm_setzero_si128();
+        __m128i height = _mm_setzero_si128();
+        __m128i holes = _mm_setzero_si128();
+        __m128i bumps = _mm_setzero_si128();
+        __m128i lines = _mm_setzero_si128();
+        for (int y = 0; y < Board::HEIGHT; ++y)
+        {
+            __m128i row = _mm_and_si128(_mm_load_si128(reinterpret_cast<const __m128i *>(lanes + y * LANES)), field);
+            seen = _mm_or_si128(seen, row);
+            height = _mm_add_epi16(height, popcount16x8(seen));
+            holes = _mm_add_epi16(holes, popcount16x8(_mm_andnot_si128(row, seen)));
+            bumps = _mm_add_epi16(bumps, popcount16x8(_mm_and_si128(_mm_xor_si128(seen, _mm_srli_epi16(seen, 1)), pairs)));
+            lines = _mm_sub_epi16(lines, _mm_cmpeq_epi16(row, field)); // cmpeq gives -1 per full row
+        }
+        _mm_store_si128(reinterpret_cast<__m128i *>(totals[0]), height);
+        _mm_store_si128(reinterpret_cast<__m128i *>(totals[1]), holes);
+        _mm_store_si128(reinterpret_cast<__m128i *>(totals[2]), bumps);
+        _mm_store_si128(reinterpret_cast<__m128i *>(totals[3]), lines);
+        for (int i = 0; i < n; ++i)
+            features[start + i] = {totals[0][i], totals[1][i], totals[2][i], totals[3][i]};
+    }
+}
+
+// Sixteen boards per iteration, one per 16-bit lane
+__attribute__((target("avx2"))) void BatchEvaluator::evaluateAvx2(const Rows *boards, int count, Features *features)
+{
+    const int LANES = 16;
+    alignas(32) uint16_t lanes[Board::HEIGHT * LANES];
+    alignas(32) uint16_t totals[4][LANES];
+    const __m256i field = _mm256_set1_epi16(static_cast<short>(FIELD));
+    const __m256i pairs = _mm256_set1_epi16(static_cast<short>(PAIRS));
+
+    for (int start = 0; start < count; start += LANES)
+    {
+        int n = count - start < LANES ? count - start : LANES;
+        transpose(boards + start, n, LANES, lanes);
+
+        __m256i seen = _mm256_setzero_si256();
+        __m256i height = _mm256_setzero_si256();
+        __m256i holes = _mm256_setzero_si256();
+        __m256i bumps = _mm256_setzero_si256();
+        __m256i lines = _mm256_setzero_si256();
+        for (int y = 0; y < Board::HEIGHT; ++y)
+        {
+            __m256i row = _mm256_and_si256(_mm256_load_si256(reinterpret_cast<const __m256i *>(lanes + y * LANES)), field);
+            seen = _mm256_or_si256(seen, row);
+            height = _mm256_add_epi16(height, popcount16x16(seen));
+            holes = _mm256_add_epi16(holes, popcount16x16(_mm256_andnot_si256(row, seen)));
+            bumps = _mm256_add_epi16(bumps, popcount16x16(_mm256_and_si256(_mm256_xor_si256(seen, _mm256_srli_epi16(seen, 1)), pairs)));
+            lines = _mm256_sub_epi16(lines, _mm256_cmpeq_epi16(row, field));
+        }
+        _mm256_store_si256(reinterpret_cast<__m256i *>(totals[0]), height);
+        _mm256_store_si256(reinterpret_cast<__m256i *>(totals[1]), holes);
+        _mm256_store_si256(reinterpret_cast<__m256i *>(totals[2]), bumps);
+        _mm256_store_si256(reinterpret_cast<__m256i *>(totals[3]), lines);
+        for (int i = 0; i < n; ++i)
+            features[start + i] = {totals[0][i], totals[1][i], totals[2][i], totals[3][i]};
+    }
+}
+#else
+// Vector kernels are x86-only; isSupported() never selects these elsewhere
+void BatchEvaluator::evaluateSsse3(const Rows *boards, int count, Features *features)
+{
+    evaluateScalar(boards, count, features);
+}
+
+void BatchEvaluator::evaluateAvx2(const Rows *boards, int count, Features *features)
+{
+    evaluateScalar(boards, count, features);
+}
+#endif
+
+// Per-cell reference: column heights from the first block found, holes by scanning down
+BatchEvaluator::Features BatchEvaluator::reference(const Rows &board)
+{
+    Features result = {0, 0, 0, 0};
+    int heights[Board::WIDTH];
+    for (int x = 0; x < Board::WIDTH; ++x)
+    {
+        heights[x] = 0;
+        bool blockAbove = false;
+        for (int y = 0; y < Board::HEIGHT; ++y)
+        {
+            bool filled = (board.rows[y] >> (x + Board::WALL_BITS)) & 1;
+            if (filled && !blockAbove)
+                heights[x] = Board::HEIGHT - y;
+            if (!filled && blockAbove)
+                result.holes++;
+            blockAbove = blockAbove || filled;
+        }
+        result.aggregateHeight += heights[x];
+        if (x > 0)
+            result.bumpiness += heights[x] > heights[x - 1] ? heights[x] - heights[x - 1] : heights[x - 1] - heights[x];
+    }
+    for (int y = 0; y < Board::HEIGHT; ++y)
+    {
+        bool full = true;
+        for (int x = 0; x < Board::WIDTH && full; ++x)
+            full = (board.rows[y] >> (x + Board::WALL_BITS)) & 1;
+        result.completedLines += full;
+    }
+    return result;
+}
+
+// Compares every supported kernel with the reference
+bool BatchEvaluator::verify(const Rows *boards, int count) const
+{
+    std::vector<Features> features(count);
+    bool ok = true;
+    for (int k = SCALAR; k <= AVX2 && ok; ++k)
+    {
+        Kernel candidate = static_cast<Kernel>(k);
+        if (!isSupported(candidate))
+            continue;
+        runKernel(candidate, boards, count, features.data());
+        for (int i = 0; i < count && ok; ++i)
+        {
+            Features expected = reference(boards[i]);
+            float expectedScore = score(expected);
+            float actualScore = score(features[i]);
+            if (std::memcmp(&expected, &features[i], sizeof(Features)) != 0 ||
+                std::memcmp(&expectedScore, &actualScore, sizeof(float)) != 0)
+            {
+                std::cerr << kernelName(candidate) << " kernel differs from the reference on board " << i
+                          << ": height " << features[i].aggregateHeight << " vs " << expected.aggregateHeight
+                          << ", holes " << features[i].holes << " vs " << expected.holes
+                          << ", bumpiness " << features[i].bumpiness << " vs " << expected.bumpiness
+                          << ", lines " << features[i].completedLines << " vs " << expected.completedLines << "\n";
+                ok = false;
+            }
+        }
+    }
+    return ok;
+}
+
+// Copies a board's rows
+void BatchEvaluator::fromBoard(const Board &board, Rows &out)
+{
+    for (int y = 0; y < Board::HEIGHT; ++y)
+        out.rows[y] = board.rowBits(y);
+}
+
+// Board rows with the piece's cells added (cells above the board are dropped)
+void BatchEvaluator::withPiece(const Board &board, const Tetromino &piece, Rows &out)
+{
+    fromBoard(board, out);
+    const PieceShape &shape = piece.getShape();
+    int shift = piece.getX() + Board::WALL_BITS;
+    for (int dy = shape.minY; dy <= shape.maxY; ++dy)
+    {
+        int y = piece.getY() + dy;
+        if (y >= 0 && y < Board::HEIGHT)
+            out.rows[y] |= static_cast<Board::Row>(shape.rowMasks[dy] << shift);
+    }
+}
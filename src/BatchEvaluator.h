@@ -0,0 +1,84 @@
+#ifndef BATCH_EVALUATOR_H
+#define BATCH_EVALUATOR_H
+
+#include "Board.h"
+
+// BatchEvaluator scores many candidate boards at once. Boards are given in row-mask form (the
+// Board::Row layout, walls included), and the features are computed with bit operations over the
+// rows: 'seen' accumulates every column that has a block at or above the current row, so
+//   aggregate height = sum over rows of popcount(seen)
+//   holes            = sum over rows of popcount(seen & ~row)
+//   bumpiness        = sum over rows of popcount((seen ^ seen >> 1) & neighbour pairs)
+// On x86 the rows of 16 (AVX2) or 8 (SSSE3) boards are processed side by side, one board per
+// 16-bit lane; other machines use the scalar kernel. The kernel is picked at runtime. Features are
+// integers, so every kernel produces identical features and, from them, identical scores.
+class BatchEvaluator
+{
+public:
+    // A candidate board in row-mask form
+    struct Rows
+    {
+        Board::Row rows[Board::HEIGHT];
+    };
+
+    // Integer features of one board
+    struct Features
+    {
+        int aggregateHeight; // Sum of column heights
+        int holes;           // Empty cells with a block somewhere above them
+        int bumpiness;       // Sum of height differences between neighbouring columns
+        int completedLines;  // Full rows (not yet cleared)
+    };
+
+    // Weights of the linear evaluation (score = sum of weight * feature)
+    struct Weights
+    {
+        float aggregateHeight = -0.510066f;
+        float holes = -0.35663f;
+        float bumpiness = -0.184483f;
+        float completedLines = 0.760666f;
+    };
+
+    // Available implementations, from slowest to fastest
+    enum Kernel
+    {
+        SCALAR, // Portable bit-parallel loop, one board at a time
+        SSSE3,  // 8 boards per 128-bit vector
+        AVX2    // 16 boards per 256-bit vector
+    };
+
+    BatchEvaluator(); // Constructor - selects the fastest kernel the CPU supports
+
+    void setWeights(const Weights &newWeights) { weights = newWeights; }
+    const Weights &getWeights() const { return weights; }
+
+    bool setKernel(Kernel newKernel); // Forces a kernel; returns false if the CPU lacks it
+    Kernel getKernel() const { return kernel; }
+    static bool isSupported(Kernel kernel);
+    static const char *kernelName(Kernel kernel);
+
+    // Computes features and scores for count boards (either output may be nullptr)
+    void evaluate(const Rows *boards, int count, Features *features, float *scores) const;
+    float score(const Features &features) const; // Weighted sum, always evaluated in the same order
+
+    // Straightforward per-cell implementation used as the reference
+    static Features reference(const Rows &board);
+
+    // Runs every supported kernel on the boards and compares features and scores bit for bit with
+    // the reference; mismatches are reported on std::cerr
+    bool verify(const Rows *boards, int count) const;
+
+    static void fromBoard(const Board &board, Rows &out); // Copies a board's rows
+    static void withPiece(const Board &board, const Tetromino &piece, Rows &out); // Board rows with the piece added (lines not cleared)
+
+private:
+    Weights weights;
+    Kernel kernel;
+
+    static void evaluateScalar(const Rows *boards, int count, Features *features);
+    static void evaluateSsse3(const Rows *boards, int count, Features *features);
+    static void evaluateAvx2(const Rows *boards, int count, Features *features);
+    static void runKernel(Kernel kernel, const Rows *boards, int count, Features *features);
+};
+
+#endif
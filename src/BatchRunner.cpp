@@ -0,0 +1,107 @@
+#include "BatchRunner.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+// Constructor - remember how to build a bot for each game
+BatchRunner::BatchRunner(PolicyFactory makePolicy, Randomizer::Mode mode)
+    : makePolicy(makePolicy), mode(mode), elapsedSeconds(0), threadsUsed(0), steals(0) {}
+
+// Plays games fresh games with seeds firstSeed, firstSeed + 1, ...
+void BatchRunner::run(int games, unsigned firstSeed, unsigned threads, long maxPieces)
+{
+    play(nullptr, games, firstSeed, threads, maxPieces);
+}
+
+// Plays games continuations of start, each bot seeded with firstSeed + i
+void BatchRunner::fork(const Engine &start, int games, unsigned firstSeed, unsigned threads, long maxPieces)
+{
+    play(&start, games, firstSeed, threads, maxPieces);
+}
+
+// Plays all games on a work-stealing pool; each game writes only its own result slot
+void BatchRunner::play(const Engine *start, int games, unsigned firstSeed, unsigned threads, long maxPieces)
+{
+    results.assign(games, GameResult());
+
+    auto begin = std::chrono::steady_clock::now();
+    {
+        ThreadPool pool(threads);
+        threadsUsed = pool.size();
+        for (int i = 0; i < games; ++i)
+        {
+            pool.submit([this, i, start, firstSeed, maxPieces]
+                        {
+                            std::unique_ptr<Policy> policy = makePolicy();
+                            Engine engine = start != nullptr ? *start : Engine(firstSeed + i, mode); // A fork is a plain copy
+                            results[i] = playGame(*policy, engine, firstSeed + i, maxPieces); });
+        }
+        pool.wait();
+        steals = pool.getSteals();
+    }
+    elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+// Runs a single game until it is over (or hits the piece cap)
+GameResult BatchRunner::playGame(Policy &policy, Engine &engine, unsigned seed, long maxPieces) const
+{
+    long firstPiece = engine.getPiecesPlaced();
+    policy.reset(seed);
+    while (!engine.isGameOver() && (maxPieces <= 0 || engine.getPiecesPlaced() - firstPiece < maxPieces))
+    {
+        engine.step(policy.chooseActions(engine));
+    }
+
+    GameResult result;
+    result.seed = seed;
+    result.score = engine.getScore();
+    result.lines = engine.getLinesCleared();
+    result.pieces = engine.getPiecesPlaced();
+    result.frames = engine.getFrame();
+    return result;
+}
+
+// Prints totals, averages and throughput of the last run
+void BatchRunner::printSummary(std::ostream &out) const
+{
+    long totalPieces = 0;
+    long totalFrames = 0;
+    long long totalScore = 0;
+    long long totalLines = 0;
+    int bestScore = 0;
+    for (const GameResult &result : results)
+    {
+        totalPieces += result.pieces;
+        totalFrames += result.frames;
+        totalScore += result.score;
+        totalLines += result.lines;
+        bestScore = std::max(bestScore, result.score);
+    }
+
+    double games = results.empty() ? 1.0 : static_cast<double>(results.size());
+    double seconds = elapsedSeconds > 0 ? elapsedSeconds : 1e-9;
+    out << "Games:           " << results.size() << " on " << threadsUsed << " threads (" << steals << " stolen)\n";
+    out << "Average score:   " << totalScore / games << " (best " << bestScore << ")\n";
+    out << "Average lines:   " << totalLines / games << "\n";
+    out << "Average pieces:  " << totalPieces / games << "\n";
+    out << "Elapsed:         " << elapsedSeconds << " s\n";
+    out << "Games/second:    " << results.size() / seconds << "\n";
+    out << "Pieces/second:   " << totalPieces / seconds << "\n";
+    out << "Frames/second:   " << totalFrames / seconds << "\n";
+}
+
+// Writes one CSV line per game
+bool BatchRunner::writeResults(const char *path) const
+{
+    std::ofstream file(path);
+    if (!file)
+        return false;
+    file << "seed,score,lines,pieces,frames\n";
+    for (const GameResult &result : results)
+    {
+        file << result.seed << ',' << result.score << ',' << result.lines << ','
+             << result.pieces << ',' << result.frames << '\n';
+    }
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,51 @@
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+#include "Policy.h"
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+// Outcome of one headless game
+struct GameResult
+{
+    unsigned seed; // Piece seed the game was played with
+    int score;     // Final score
+    int lines;     // Lines cleared
+    long pieces;   // Pieces locked
+    long frames;   // Frames simulated
+};
+
+// BatchRunner plays many independent headless games across all cores and summarizes them
+class BatchRunner
+{
+public:
+    typedef std::function<std::unique_ptr<Policy>()> PolicyFactory; // Creates one bot per game
+
+    BatchRunner(PolicyFactory makePolicy, Randomizer::Mode mode); // Constructor - bots are created with makePolicy
+
+    // Plays games with seeds firstSeed, firstSeed + 1, ...; maxPieces caps endless games (0 = no cap)
+    void run(int games, unsigned firstSeed, unsigned threads, long maxPieces);
+
+    // Plays games that all continue from start (a restored checkpoint); only the bots' seeds differ.
+    // maxPieces counts the pieces placed after start.
+    void fork(const Engine &start, int games, unsigned firstSeed, unsigned threads, long maxPieces);
+
+    void printSummary(std::ostream &out) const;  // Aggregate totals and throughput
+    bool writeResults(const char *path) const;   // Per-game results as CSV
+    const std::vector<GameResult> &getResults() const { return results; }
+
+private:
+    PolicyFactory makePolicy;
+    Randomizer::Mode mode;           // Piece randomizer used by every game
+    std::vector<GameResult> results; // One entry per game, in seed order
+    double elapsedSeconds;           // Wall time of the last run
+    unsigned threadsUsed;            // Worker threads used by the last run
+    unsigned long steals;            // Games picked up through work stealing
+
+    void play(const Engine *start, int games, unsigned firstSeed, unsigned threads, long maxPieces); // run() or fork() (start = nullptr: fresh games)
+    GameResult playGame(Policy &policy, Engine &engine, unsigned seed, long maxPieces) const;      // Plays one game to the end
+};
+
+#endif
@@ -0,0 +1,559 @@
+#include "Benchmark.h"
+#include "AutoPlayer.h"
+#include "BatchEvaluator.h"
+#include "Checkpoint.h"
+#include "Engine.h"
+#include "MoveGenerator.h"
+#include "Policy.h"
+#include "ThreadPool.h"
+#include "TranspositionTable.h"
+#include "VecEnv.h"
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <streambuf>
+
+namespace
+{
+    const unsigned FIXTURE_SEED = 12345; // Fixed so every run measures the same boards
+
+    // Stream buffer that discards everything (used to time Board::draw without a terminal)
+    class NullBuffer : public std::streambuf
+    {
+    protected:
+        int overflow(int c) override { return c; }
+        std::streamsize xsputn(const char *, std::streamsize n) override { return n; }
+    };
+
+    // Keeps results alive so the compiler cannot drop the measured work
+    volatile long sink;
+
+    // Fills column x from the floor up to the given height
+    void fillColumn(Board &board, int x, int height, char pieceChar)
+    {
+        for (int y = Board::HEIGHT - height; y < Board::HEIGHT; ++y)
+            board.fillCell(x, y, pieceChar);
+    }
+
+    // Random stack whose columns have heights in [0, maxHeight]; column well stays empty
+    void fillJagged(Board &board, std::mt19937 &rng, int maxHeight, int well, int floorRows)
+    {
+        static const char PIECES[] = "IOTSZJL";
+        for (int x = 0; x < Board::WIDTH; ++x)
+        {
+            if (x == well)
+                continue;
+            int height = floorRows + static_cast<int>(rng() % (maxHeight + 1));
+            fillColumn(board, x, height, PIECES[rng() % 7]);
+        }
+    }
+}
+
+// Constructor - remember the target time per case
+Benchmark::Benchmark(double secondsPerCase) : secondsPerCase(secondsPerCase) {}
+
+// Builds the shared board fixtures
+std::vector<Benchmark::Fixture> Benchmark::makeFixtures()
+{
+    std::mt19937 rng(FIXTURE_SEED);
+    std::vector<Fixture> fixtures;
+
+    fixtures.push_back({"empty", Board()});
+
+    Fixture halfFull = {"half-full", Board()};
+    for (int y = Board::HEIGHT / 2; y < Board::HEIGHT; ++y)
+    {
+        int gap = static_cast<int>(rng() % Board::WIDTH); // One hole per row keeps every row incomplete
+        for (int x = 0; x < Board::WIDTH; ++x)
+        {
+            if (x != gap && rng() % 4 != 0)
+                halfFull.board.fillCell(x, y, 'T');
+        }
+    }
+    fixtures.push_back(halfFull);
+
+    Fixture jagged = {"jagged", Board()};
+    fillJagged(jagged.board, rng, 12, static_cast<int>(rng() % Board::WIDTH), 0);
+    fixtures.push_back(jagged);
+
+    Fixture tetrisReady = {"tetris-ready", Board()};
+    fillJagged(tetrisReady.board, rng, 6, Board::WIDTH - 1, 4); // Four full rows except the rightmost well
+    fixtures.push_back(tetrisReady);
+
+    return fixtures;
+}
+
+// Times an operation by running it in growing batches until the target time is reached
+template <typename Operation>
+void Benchmark::measure(const char *name, const char *fixture, Operation operation, int itemsPerOp)
+{
+    typedef std::chrono::steady_clock Clock;
+    long iterations = 0;
+    long batch = 64;
+    double elapsed = 0;
+    auto start = Clock::now();
+    while (elapsed < secondsPerCase)
+    {
+        for (long i = 0; i < batch; ++i)
+            operation();
+        iterations += batch;
+        batch *= 2;
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    }
+    iterations *= itemsPerOp;
+    addResult(name, fixture, elapsed * 1e9 / iterations, "ns/op", iterations);
+}
+
+// Records one result
+void Benchmark::addResult(const char *name, const char *fixture, double value, const char *unit, long iterations)
+{
+    results.push_back({name, fixture, value, unit, iterations});
+}
+
+// Runs every benchmark case
+void Benchmark::runAll()
+{
+    results.clear();
+    std::vector<Fixture> fixtures = makeFixtures();
+    benchPieces(fixtures);
+    benchLineClears();
+    benchUndo(fixtures);
+    benchTranspositionTable();
+    benchEvaluator(fixtures);
+    benchBoardSizes();
+    benchDraw(fixtures);
+    benchSimulation();
+    benchCheckpoints();
+    benchVecEnv();
+    benchAutoPlayer();
+}
+
+// Collision checks, moves, rotations and the hard-drop loop on each fixture
+void Benchmark::benchPieces(const std::vector<Fixture> &fixtures)
+{
+    for (const Fixture &fixture : fixtures)
+    {
+        const Board &board = fixture.board;
+
+        // A fixed mix of piece types, rotations and positions, including blocked ones
+        std::mt19937 rng(FIXTURE_SEED);
+        std::vector<Tetromino> probes;
+        for (int i = 0; i < 256; ++i)
+        {
+            Tetromino probe(static_cast<Tetromino::Type>(rng() % 7));
+            for (int r = static_cast<int>(rng() % 4); r > 0; --r)
+                probe.rotate();
+            probe.setPosition(static_cast<int>(rng() % (Board::WIDTH + 2)) - 1, static_cast<int>(rng() % Board::HEIGHT));
+            probes.push_back(probe);
+        }
+
+        size_t next = 0;
+        measure("Tetromino::collidesWith", fixture.name, [&]
+                {
+                    sink += probes[next].collidesWith(board);
+                    next = (next + 1) % probes.size(); });
+
+        Tetromino piece(Tetromino::T);
+        int direction = 1;
+        measure("Board::movePiece", fixture.name, [&]
+                {
+                    if (!board.movePiece(piece, direction, 0))
+                        direction = -direction; // Bounce between the walls
+                    sink += piece.getX(); });
+
+        measure("Board::rotatePiece", fixture.name, [&]
+                { sink += board.rotatePiece(piece); });
+
+        // Hard drop as Engine::input does it (from column heights), for every piece type from the spawn position
+        int type = 0;
+        measure("hard drop", fixture.name, [&]
+                {
+                    Tetromino drop(static_cast<Tetromino::Type>(type));
+                    type = (type + 1) % 7;
+                    drop.move(0, board.dropDistance(drop));
+                    sink += drop.getY(); });
+
+        // The step-by-step loop it replaced, for comparison
+        measure("hard drop (stepped)", fixture.name, [&]
+                {
+                    Tetromino drop(static_cast<Tetromino::Type>(type));
+                    type = (type + 1) % 7;
+                    while (board.movePiece(drop, 0, 1))
+                        ;
+                    sink += drop.getY(); });
+    }
+}
+
+// clearFullLines on boards with 0 to 4 full rows under a jagged stack
+void Benchmark::benchLineClears()
+{
+    std::mt19937 rng(FIXTURE_SEED);
+    for (int full = 0; full <= 4; ++full)
+    {
+        Board fixture;
+        fillJagged(fixture, rng, 8, Board::WIDTH - 1, 0);
+        for (int row = 0; row < full; ++row)
+            fixture.fillCell(Board::WIDTH - 1, Board::HEIGHT - 1 - row, 'I'); // Complete the bottom rows; the rest keep the well
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "Board::clearFullLines (%d full)", full);
+        measure(name, "jagged", [&]
+                {
+                    Board board = fixture; // Clearing is destructive, so work on a copy
+                    sink += board.clearFullLines(); });
+    }
+
+    Board fixture;
+    fillJagged(fixture, rng, 8, Board::WIDTH - 1, 0); // The same kind of stack the clears above copy
+    measure("Board copy (included above)", "jagged", [&]
+            {
+                Board board = fixture;
+                sink += board.rowBits(Board::HEIGHT - 1); });
+}
+
+// Placing a hard-dropped piece and reverting it, the inner step of a lookahead search
+void Benchmark::benchUndo(const std::vector<Fixture> &fixtures)
+{
+    Board::Journal journal;
+    Board::Snapshot snapshot;
+    for (const Fixture &fixture : fixtures)
+    {
+        Board board = fixture.board;
+        board.clearFullLines(); // No pending full rows (makeMove requires it)
+
+        // The same seven drops for every method
+        std::vector<Tetromino> drops;
+        for (int type = 0; type < 7; ++type)
+        {
+            Tetromino drop(static_cast<Tetromino::Type>(type));
+            drop.move(0, board.dropDistance(drop));
+            drops.push_back(drop);
+        }
+
+        size_t next = 0;
+        measure("Board::makeMove + unmakeMove", fixture.name, [&]
+                {
+                    sink += board.makeMove(drops[next], journal);
+                    board.unmakeMove(journal);
+                    next = (next + 1) % drops.size(); });
+
+        measure("Board::save + place + restore", fixture.name, [&]
+                {
+                    board.save(snapshot);
+                    board.placePiece(drops[next]);
+                    sink += board.clearFullLines();
+                    board.restore(snapshot);
+                    next = (next + 1) % drops.size(); });
+
+        measure("Board copy + place", fixture.name, [&]
+                {
+                    Board copy = board;
+                    copy.placePiece(drops[next]);
+                    sink += copy.clearFullLines();
+                    next = (next + 1) % drops.size(); });
+    }
+}
+
+// Stores and probes with keys of real positions, in a table large enough to miss the cache
+void Benchmark::benchTranspositionTable()
+{
+    const int KEY_COUNT = 4096;
+    std::mt19937 rng(FIXTURE_SEED);
+    std::vector<uint64_t> keys;
+    Board board;
+    for (int i = 0; i < KEY_COUNT; ++i)
+    {
+        Tetromino piece(static_cast<Tetromino::Type>(rng() % 7));
+        piece.setPosition(static_cast<int>(rng() % (Board::WIDTH - 3)), 0);
+        piece.move(0, board.dropDistance(piece));
+        board.placePiece(piece);
+        board.clearFullLines();
+        if (board.getAggregateHeight() > Board::WIDTH * Board::HEIGHT / 2)
+            board.clear();
+        keys.push_back(board.positionKey(Tetromino(static_cast<Tetromino::Type>(rng() % 7))));
+    }
+
+    TranspositionTable table(20);
+    size_t next = 0;
+    measure("TranspositionTable::store", "4096 positions", [&]
+            {
+                table.store(keys[next], {static_cast<float>(next), 1});
+                next = (next + 1) % keys.size(); });
+    measure("TranspositionTable::probe (hit)", "4096 positions", [&]
+            {
+                TranspositionTable::Value value;
+                sink += table.probe(keys[next], value);
+                next = (next + 1) % keys.size(); });
+    measure("TranspositionTable::probe (miss)", "4096 positions", [&]
+            {
+                TranspositionTable::Value value;
+                sink += table.probe(keys[next] ^ 0x8000000000000000ull, value);
+                next = (next + 1) % keys.size(); });
+}
+
+// Scores every placement of every piece on the fixtures, as a bot would before choosing a move
+void Benchmark::benchEvaluator(const std::vector<Fixture> &fixtures)
+{
+    MoveGenerator generator;
+    std::vector<BatchEvaluator::Rows> candidates;
+    for (const Fixture &fixture : fixtures)
+    {
+        for (int type = 0; type < 7; ++type)
+        {
+            int count = generator.generate(fixture.board, Tetromino(static_cast<Tetromino::Type>(type)));
+            for (int i = 0; i < count; ++i)
+            {
+                candidates.emplace_back();
+                BatchEvaluator::withPiece(fixture.board, generator.getPlacement(i), candidates.back());
+            }
+        }
+    }
+    int count = static_cast<int>(candidates.size());
+
+    BatchEvaluator evaluator;
+    if (!evaluator.verify(candidates.data(), count))
+    {
+        std::cerr << "BatchEvaluator does not match its reference; skipping its timings\n";
+        return;
+    }
+
+    std::vector<BatchEvaluator::Features> features(count);
+    std::vector<float> scores(count);
+    measure("BatchEvaluator::reference", "all placements", [&]
+            {
+                for (int i = 0; i < count; ++i)
+                    scores[i] = evaluator.score(BatchEvaluator::reference(candidates[i]));
+                sink += static_cast<long>(scores[0]); }, count);
+
+    for (int k = BatchEvaluator::SCALAR; k <= BatchEvaluator::AVX2; ++k)
+    {
+        if (!evaluator.setKernel(static_cast<BatchEvaluator::Kernel>(k)))
+            continue;
+        char name[64];
+        std::snprintf(name, sizeof(name), "BatchEvaluator::evaluate (%s)", BatchEvaluator::kernelName(evaluator.getKernel()));
+        measure(name, "all placements", [&]
+                {
+                    evaluator.evaluate(candidates.data(), count, features.data(), scores.data());
+                    sink += static_cast<long>(scores[0]); }, count);
+    }
+}
+
+// Board::draw with std::cout pointed at a discarding buffer
+void Benchmark::benchDraw(const std::vector<Fixture> &fixtures)
+{
+    NullBuffer nullBuffer;
+    std::streambuf *original = std::cout.rdbuf(&nullBuffer);
+    Tetromino piece(Tetromino::T);
+    for (const Fixture &fixture : fixtures)
+    {
+        measure("Board::draw", fixture.name, [&]
+                { fixture.board.draw(piece); });
+    }
+    std::cout.rdbuf(original);
+}
+
+// Whole games through the Engine with the random bot, as pieces and frames per second
+void Benchmark::benchSimulation()
+{
+    typedef std::chrono::steady_clock Clock;
+    RandomPolicy policy;
+    Engine engine;
+    long pieces = 0;
+    long frames = 0;
+    unsigned seed = FIXTURE_SEED;
+    double elapsed = 0;
+    auto start = Clock::now();
+    while (elapsed < secondsPerCase * 4)
+    {
+        engine.reset(seed);
+        policy.reset(seed);
+        seed++;
+        while (!engine.isGameOver())
+            engine.step(policy.chooseActions(engine));
+        pieces += engine.getPiecesPlaced();
+        frames += engine.getFrame();
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    }
+    addResult("simulation", "random bot", pieces / elapsed, "pieces/s", pieces);
+    addResult("simulation", "random bot", frames / elapsed, "frames/s", frames);
+}
+
+// Checks that saved games restore with the same future, then times both directions on a game in
+// progress
+void Benchmark::benchCheckpoints()
+{
+    int positions = Checkpoint::verifyGames(FIXTURE_SEED, 8);
+    if (positions < 0)
+    {
+        std::cerr << "A restored checkpoint diverged from its original game; skipping the checkpoint timings\n";
+        return;
+    }
+    std::cout << "Checkpoint round trip verified at " << positions << " positions\n";
+
+    RandomPolicy policy;
+    Engine engine(FIXTURE_SEED);
+    policy.reset(FIXTURE_SEED);
+    while (engine.getPiecesPlaced() < 40 && !engine.isGameOver())
+        engine.step(policy.chooseActions(engine));
+
+    Checkpoint checkpoint;
+    Engine restored;
+    measure("Engine::save", "40 pieces in", [&]
+            {
+                engine.save(checkpoint);
+                sink += checkpoint.checksum; });
+    measure("Engine::restore", "40 pieces in", [&]
+            { sink += restored.restore(checkpoint) ? 1 : 0; });
+}
+
+// The same drop-place-clear step on each board size compiled in Board.cpp, to compare row widths
+void Benchmark::benchBoardSizes()
+{
+    benchBoardSize<10, 20>("10x20 uint16 rows");
+    benchBoardSize<10, 40>("10x40 uint16 rows");
+    benchBoardSize<16, 20>("16x20 uint32 rows");
+    benchBoardSize<32, 20>("32x20 uint64 rows");
+}
+
+// Random pieces in random columns are hard dropped, placed and cleared; the board is emptied once
+// it is half full, so every size spends its time on a similar stack
+template <int W, int H>
+void Benchmark::benchBoardSize(const char *fixture)
+{
+    typedef BasicBoard<W, H> SizedBoard;
+    const int MOVES = 1024;
+    std::mt19937 rng(FIXTURE_SEED);
+    std::vector<Tetromino> moves;
+    for (int i = 0; i < MOVES; ++i)
+    {
+        Tetromino piece(static_cast<Tetromino::Type>(rng() % 7));
+        for (int turns = rng() % 4; turns > 0; --turns)
+            piece.rotate();
+        const PieceShape &shape = piece.getShape();
+        piece.setPosition(-shape.minX + static_cast<int>(rng() % (W - (shape.maxX - shape.minX))), 0);
+        moves.push_back(piece);
+    }
+
+    SizedBoard board;
+    int next = 0;
+    measure("drop + place + clear", fixture, [&]
+            {
+                Tetromino piece = moves[next];
+                next = (next + 1) & (MOVES - 1);
+                if (board.isCollision(piece) || board.getAggregateHeight() > W * H / 2)
+                    board.clear();
+                piece.move(0, board.dropDistance(piece));
+                board.placePiece(piece);
+                sink += board.clearFullLines(); });
+}
+
+// Many games stepped with random actions: VecEnv against the same number of separate Engines.
+// Both consume one precomputed action table, so the timings cover only the simulation.
+void Benchmark::benchVecEnv()
+{
+    typedef std::chrono::steady_clock Clock;
+    const int GAMES = 1024;
+    const int TABLE_STEPS = 64;
+    std::mt19937 rng(FIXTURE_SEED);
+    std::vector<uint8_t> actions(static_cast<size_t>(GAMES) * TABLE_STEPS);
+    for (uint8_t &action : actions)
+    {
+        int roll = static_cast<int>(rng() % 16);
+        action = roll < 3 ? Engine::MOVE_LEFT : roll < 6 ? Engine::MOVE_RIGHT : roll < 8 ? Engine::ROTATE
+               : roll < 10 ? Engine::SOFT_DROP : roll == 10 ? Engine::HARD_DROP : 0;
+    }
+
+    VecEnv env(GAMES, FIXTURE_SEED);
+    long steps = 0;
+    double elapsed = 0;
+    auto start = Clock::now();
+    while (elapsed < secondsPerCase * 4)
+    {
+        env.step(&actions[static_cast<size_t>(steps / GAMES % TABLE_STEPS) * GAMES]);
+        steps += GAMES;
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    }
+    addResult("VecEnv::step", "1024 games", steps / elapsed, "env-steps/s", steps);
+
+    std::vector<Engine> engines;
+    for (int i = 0; i < GAMES; ++i)
+        engines.emplace_back(FIXTURE_SEED + i);
+    unsigned seed = FIXTURE_SEED + GAMES;
+    steps = 0;
+    elapsed = 0;
+    start = Clock::now();
+    while (elapsed < secondsPerCase * 4)
+    {
+        const uint8_t *row = &actions[static_cast<size_t>(steps / GAMES % TABLE_STEPS) * GAMES];
+        for (int i = 0; i < GAMES; ++i)
+        {
+            engines[i].step(row[i]);
+            if (engines[i].isGameOver())
+                engines[i].reset(seed++);
+        }
+        steps += GAMES;
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    }
+    addResult("Engine::step (one per game)", "1024 games", steps / elapsed, "env-steps/s", steps);
+}
+
+// The beam-search bot (beam 16, depth 3) playing a game opening, searching on the calling thread and on a pool
+void Benchmark::benchAutoPlayer()
+{
+    const long PIECES = 200;
+    ThreadPool pool;
+    AutoPlayer::Settings settings;
+    settings.beamWidth = 16;
+    settings.depth = 3;
+
+    for (int pooled = 0; pooled < 2; ++pooled)
+    {
+        AutoPlayer player(settings, pooled ? &pool : nullptr);
+        Engine engine(FIXTURE_SEED);
+        player.reset(FIXTURE_SEED);
+        while (!engine.isGameOver() && engine.getPiecesPlaced() < PIECES)
+            engine.step(player.chooseActions(engine));
+
+        char fixture[32];
+        std::snprintf(fixture, sizeof(fixture), pooled ? "pool of %u" : "serial", pool.size());
+        const AutoPlayer::Stats &stats = player.getStats();
+        addResult("AutoPlayer decision", fixture, stats.meanDecisionMs() * 1e6, "ns/op", stats.decisions);
+        addResult("AutoPlayer search", fixture, stats.nodesPerSecond(), "nodes/s", stats.nodes);
+    }
+}
+
+// Prints the results as an aligned table
+void Benchmark::print(std::ostream &out) const
+{
+    for (const Result &result : results)
+    {
+        out << std::left << std::setw(36) << result.name << std::setw(14) << result.fixture
+            << std::right << std::setw(14) << std::fixed << std::setprecision(1) << result.value
+            << ' ' << result.unit << "\n";
+    }
+    out.unsetf(std::ios::fixed);
+}
+
+// Writes the results as a JSON document
+bool Benchmark::writeJson(const char *path) const
+{
+    bool toStdout = std::string(path) == "-";
+    FILE *file = toStdout ? stdout : std::fopen(path, "w");
+    if (file == nullptr)
+        return false;
+
+    std::fprintf(file, "{\n  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const Result &result = results[i];
+        std::fprintf(file, "    {\"name\": \"%s\", \"fixture\": \"%s\", \"value\": %.3f, \"unit\": \"%s\", \"iterations\": %ld}%s\n",
+                     result.name.c_str(), result.fixture.c_str(), result.value, result.unit.c_str(), result.iterations,
+                     i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(file, "  ]\n}\n");
+    if (toStdout)
+        return std::fflush(file) == 0;
+    return std::fclose(file) == 0;
+}
@@ -0,0 +1,63 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "Board.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Benchmark times the hot board and piece operations on fixed-seed board fixtures
+// and writes the results as JSON, so runs from different commits can be compared
+class Benchmark
+{
+public:
+    explicit Benchmark(double secondsPerCase = 0.05); // Constructor - target measuring time per case
+
+    void runAll();                       // Runs every benchmark case
+    void print(std::ostream &out) const; // Human-readable table
+    bool writeJson(const char *path) const;  // Machine-readable results ("-" = stdout)
+
+private:
+    // One measured case
+    struct Result
+    {
+        std::string name;    // Operation measured
+        std::string fixture; // Board the operation ran on
+        double value;        // Measurement (see unit)
+        std::string unit;    // "ns/op" or a throughput unit
+        long iterations;     // Operations timed
+    };
+
+    // A named board used as benchmark input
+    struct Fixture
+    {
+        const char *name;
+        Board board;
+    };
+
+    double secondsPerCase;
+    std::vector<Result> results;
+
+    static std::vector<Fixture> makeFixtures(); // Empty, half-full, jagged and four-line-clear boards
+
+    template <typename Operation>
+    void measure(const char *name, const char *fixture, Operation operation, int itemsPerOp = 1); // Times operation() in ns per item
+
+    void addResult(const char *name, const char *fixture, double value, const char *unit, long iterations);
+
+    void benchPieces(const std::vector<Fixture> &fixtures); // Collision, move, rotate, hard drop
+    void benchLineClears();                                 // clearFullLines with 0 to 4 full rows
+    void benchUndo(const std::vector<Fixture> &fixtures);   // Place-and-revert for search: make/unmake, snapshots, copies
+    void benchTranspositionTable();                         // Store and probe costs of the shared position table
+    void benchEvaluator(const std::vector<Fixture> &fixtures); // Candidate evaluation per kernel, after a bit-exact check
+    void benchBoardSizes();                                 // Drop, place and clear on every instantiated board size
+    template <int W, int H>
+    void benchBoardSize(const char *fixture);               // ... on one size
+    void benchDraw(const std::vector<Fixture> &fixtures);   // Board::draw into a discarded stream
+    void benchSimulation();                                 // End-to-end pieces per second
+    void benchCheckpoints();                                // Engine save and restore, after a round-trip self-check
+    void benchVecEnv();                                     // Lockstep games per second: VecEnv against separate Engines
+    void benchAutoPlayer();                                 // Bot decision latency and nodes per second, serial and pooled
+};
+
+#endif
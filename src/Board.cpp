@@ -1,47 +1,73 @@
 #include "Board.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <string>
 
 // Constructor - initializes the board to empty
-Board::Board()
+template <int W, int H>
+BasicBoard<W, H>::BasicBoard()
 {
     clear();
 }
 
 // Clears the entire board (sets all cells to empty)
-void Board::clear()
+template <int W, int H>
+void BasicBoard<W, H>::clear()
 {
     for (int y = 0; y < HEIGHT; ++y)
     {
+        rows[y] = EMPTY_ROW;
         for (int x = 0; x < WIDTH; ++x)
         {
-            grid[y][x] = ' '; // Empty cell
+            cells[y][x] = ' '; // Empty cell
         }
+        rowFill[y] = 0;
     }
+    for (int x = 0; x < WIDTH; ++x)
+    {
+        stats.heights[x] = 0;
+    }
+    stats.cellCount = 0;
+    stats.dirtyTop = HEIGHT;
+    stats.dirtyBottom = -1;
+    stats.hash = 0;
+    recomputeSurface();
 }
 
 // Draws the current game board along with the active falling piece
-void Board::draw(const Tetromino &piece) const
+template <int W, int H>
+void BasicBoard<W, H>::draw(const Tetromino &piece) const
 {
     char tempGrid[HEIGHT][WIDTH];
+    copyCells(piece, tempGrid);
 
-    // Copy the current board into tempGrid
-    for (int y = 0; y < HEIGHT; ++y)
+    // Render the combined grid (board + piece)
+    drawBoard(tempGrid);
+}
+
+// Copies the grid with the falling piece overlaid, for renderers that draw it themselves
+template <int W, int H>
+void BasicBoard<W, H>::copyCells(const Tetromino &piece, char out[HEIGHT][WIDTH]) const
+{
+    std::memcpy(out, cells, sizeof(cells));
+    char pieceChar = Tetromino::typeChar(piece.getType());
+    for (const PieceShape::Cell &cell : piece.getShape().cells)
     {
-        for (int x = 0; x < WIDTH; ++x)
+        int drawX = piece.getX() + cell.x;
+        int drawY = piece.getY() + cell.y;
+        if (drawX >= 0 && drawX < WIDTH && drawY >= 0 && drawY < HEIGHT)
         {
-            tempGrid[y][x] = grid[y][x];
+            out[drawY][drawX] = pieceChar;
         }
     }
-
-    // Overlay the falling piece onto the tempGrid
-    piece.draw(tempGrid);
-
-    // Render the combined grid (board + piece)
-    drawBoard(tempGrid);
 }
 
 // Moves a piece if possible, returning false if blocked
-bool Board::movePiece(Tetromino &piece, int dx, int dy)
+template <int W, int H>
+bool BasicBoard<W, H>::movePiece(Tetromino &piece, int dx, int dy) const
 {
     piece.move(dx, dy);
     if (isCollision(piece))
@@ -53,68 +79,394 @@ bool Board::movePiece(Tetromino &piece, int dx, int dy)
 }
 
 // Rotates the piece, reverting if it causes a collision
-void Board::rotatePiece(Tetromino &piece)
+template <int W, int H>
+bool BasicBoard<W, H>::rotatePiece(Tetromino &piece) const
 {
     piece.rotate();
     if (isCollision(piece))
     {
-        piece.rotateBack();
+        piece.rotateBack(); // Undo rotation if collision detected
+        return false;
     }
+    return true;
 }
 
-// Places the falling piece permanently onto the grid
-void Board::placePiece(const Tetromino &piece)
+// Places the falling piece permanently onto the grid. The statistics for the columns it covers
+// are taken out once, the cells are filled, and the new terms are added back.
+template <int W, int H>
+void BasicBoard<W, H>::placePiece(const Tetromino &piece)
 {
-    piece.placeOnBoard(grid);
+    const PieceShape &shape = piece.getShape();
+    int first = std::max(piece.getX() + shape.minX, 0);
+    int last = std::min(piece.getX() + shape.maxX, WIDTH - 1);
+    char pieceChar = Tetromino::typeChar(piece.getType());
+
+    adjustSurface(first, last, -1);
+    for (const PieceShape::Cell &cell : shape.cells)
+    {
+        int x = piece.getX() + cell.x;
+        int y = piece.getY() + cell.y;
+        if (x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT)
+            continue; // Clipped (only happens to a piece that spawned into the stack)
+
+        Row bit = columnBit(x);
+        cells[y][x] = pieceChar;
+        if (rows[y] & bit)
+            continue;
+        rows[y] |= bit;
+        rowFill[y]++;
+        stats.cellCount++;
+        stats.hash ^= ZOBRIST.cells[y][x];
+        stats.dirtyTop = std::min(stats.dirtyTop, y);
+        stats.dirtyBottom = std::max(stats.dirtyBottom, y);
+        if (HEIGHT - y > stats.heights[x])
+        {
+            stats.aggregateHeight += HEIGHT - y - stats.heights[x];
+            stats.heights[x] = static_cast<uint8_t>(HEIGHT - y);
+        }
+    }
+    adjustSurface(first, last, 1);
+}
+
+// Marks a single cell as occupied in both the row mask and the color layer
+template <int W, int H>
+void BasicBoard<W, H>::fillCell(int x, int y, char pieceChar)
+{
+    Row bit = columnBit(x);
+    cells[y][x] = pieceChar;
+    if (rows[y] & bit)
+        return; // Already occupied; only the color changes
+
+    rows[y] |= bit;
+    rowFill[y]++;
+    stats.cellCount++;
+    stats.hash ^= ZOBRIST.cells[y][x];
+    if (y < stats.dirtyTop)
+        stats.dirtyTop = y;
+    if (y > stats.dirtyBottom)
+        stats.dirtyBottom = y;
+    if (HEIGHT - y > stats.heights[x])
+        setHeight(x, HEIGHT - y); // New top of the column (any gap below it becomes holes)
 }
 
-// Checks for and clears fully filled lines, returning number of cleared lines
-int Board::clearFullLines()
+// Number of rows the piece can fall. Column heights answer this directly unless part of the
+// piece is already below the top of a column (tucked under an overhang); then it is stepped down.
+template <int W, int H>
+int BasicBoard<W, H>::dropDistance(const Tetromino &piece) const
 {
+    const PieceShape &shape = piece.getShape();
+    int distance = HEIGHT;
+    for (int dx = shape.minX; dx <= shape.maxX; ++dx)
+    {
+        int bottom = piece.getY() + shape.bottoms[dx];     // Lowest cell of the piece in this column
+        int surface = HEIGHT - stats.heights[piece.getX() + dx]; // Topmost occupied row (HEIGHT = floor)
+        if (bottom >= surface)
+        {
+            Tetromino probe = piece;
+            int steps = 0;
+            while (movePiece(probe, 0, 1))
+                steps++;
+            return steps;
+        }
+        if (surface - 1 - bottom < distance)
+            distance = surface - 1 - bottom;
+    }
+    return distance;
+}
+
+// Depth of the well at column x: how far it lies below the lower of its neighbours
+template <int W, int H>
+int BasicBoard<W, H>::wellDepth(int x) const
+{
+    int left = x > 0 ? stats.heights[x - 1] : HEIGHT;
+    int right = x < WIDTH - 1 ? stats.heights[x + 1] : HEIGHT;
+    int depth = (left < right ? left : right) - stats.heights[x];
+    return depth > 0 ? depth : 0;
+}
+
+// Changes the height of one column, updating only the statistics that depend on it
+template <int W, int H>
+void BasicBoard<W, H>::setHeight(int x, int height)
+{
+    adjustSurface(x, x, -1);
+    stats.aggregateHeight += height - stats.heights[x];
+    stats.heights[x] = static_cast<uint8_t>(height);
+    adjustSurface(x, x, 1);
+}
+
+// Bumpiness and well terms that involve columns first to last
+template <int W, int H>
+void BasicBoard<W, H>::adjustSurface(int first, int last, int sign)
+{
+    int bumps = 0;
+    for (int x = std::max(first - 1, 0); x <= std::min(last, WIDTH - 2); ++x)
+        bumps += std::abs(stats.heights[x] - stats.heights[x + 1]);
+    int wells = 0;
+    for (int x = std::max(first - 1, 0); x <= std::min(last + 1, WIDTH - 1); ++x)
+        wells += wellDepth(x);
+    stats.bumpiness += sign * bumps;
+    stats.wellDepthSum += sign * wells;
+}
+
+// Zobrist contribution of one row (empty rows, the common case above the stack, contribute nothing)
+template <int W, int H>
+uint64_t BasicBoard<W, H>::rowHash(int y) const
+{
+    uint64_t hash = 0;
+    if (rows[y] == EMPTY_ROW)
+        return hash;
+    for (int x = 0; x < WIDTH; ++x)
+    {
+        if (rows[y] & columnBit(x))
+            hash ^= ZOBRIST.cells[y][x];
+    }
+    return hash;
+}
+
+// Key for a search position: the board plus the type and rotation of the piece to be placed
+template <int W, int H>
+uint64_t BasicBoard<W, H>::positionKey(const Tetromino &piece) const
+{
+    return stats.hash ^ ZOBRIST.pieces[piece.getType()][piece.getRotation()];
+}
+
+// Rebuilds the height-derived statistics from scratch (after line clears)
+template <int W, int H>
+void BasicBoard<W, H>::recomputeSurface()
+{
+    stats.aggregateHeight = 0;
+    stats.bumpiness = 0;
+    stats.wellDepthSum = 0;
+    for (int x = 0; x < WIDTH; ++x)
+    {
+        stats.aggregateHeight += stats.heights[x];
+        stats.wellDepthSum += wellDepth(x);
+        if (x < WIDTH - 1)
+            stats.bumpiness += std::abs(stats.heights[x] - stats.heights[x + 1]);
+    }
+}
+
+// Checks for and clears fully filled lines, returning number of cleared lines.
+// Only rows filled since the previous call can have become full, so only those are checked.
+template <int W, int H>
+int BasicBoard<W, H>::clearFullLines()
+{
+    PROFILE_SCOPE(CLEAR_LINES);
+
+    int top = stats.dirtyTop;
+    int bottom = stats.dirtyBottom;
+    stats.dirtyTop = HEIGHT;
+    stats.dirtyBottom = -1;
+
+    int fullRows = 0;
+    for (int y = top; y <= bottom; ++y)
+    {
+        if (rowFill[y] == WIDTH)
+            fullRows++;
+    }
+    if (fullRows == 0)
+        return 0;
+
+    // Every row from the top down to the lowest full row changes position, so its keys change;
+    // take those rows out of the hash now and add the shifted rows back afterwards
+    for (int row = 0; row <= bottom; ++row)
+        stats.hash ^= rowHash(row);
+
     int linesCleared = 0;
+    int y = bottom; // Rows below the touched range do not move
 
-    for (int y = 0; y < HEIGHT; ++y)
+    // Walk upwards; each run of surviving rows is moved down in one block
+    // by the number of full rows found below it
+    while (y >= 0)
     {
-        bool full = true;
-        for (int x = 0; x < WIDTH; ++x)
+        if (rows[y] == FULL_ROW)
         {
-            if (grid[y][x] == ' ')
-            {
-                full = false;
-                break;
-            }
+            linesCleared++;
+            --y;
+            continue;
         }
-        if (full)
+
+        int runBottom = y;
+        while (y >= 0 && rows[y] != FULL_ROW)
         {
-            // Shift all rows above down by one
-            for (int row = y; row > 0; --row)
-            {
-                for (int col = 0; col < WIDTH; ++col)
-                {
-                    grid[row][col] = grid[row - 1][col];
-                }
-            }
-            // Clear the top row
-            for (int col = 0; col < WIDTH; ++col)
+            --y;
+        }
+        if (linesCleared > 0)
+        {
+            int runTop = y + 1;
+            int count = runBottom - runTop + 1;
+            std::memmove(&rows[runTop + linesCleared], &rows[runTop], count * sizeof(Row));
+            std::memmove(cells[runTop + linesCleared], cells[runTop], count * sizeof(cells[0]));
+            std::memmove(&rowFill[runTop + linesCleared], &rowFill[runTop], count * sizeof(rowFill[0]));
+        }
+    }
+
+    // Clear the rows uncovered at the top
+    for (int row = 0; row < linesCleared; ++row)
+    {
+        rows[row] = EMPTY_ROW;
+        rowFill[row] = 0;
+        std::memset(cells[row], ' ', sizeof(cells[row]));
+    }
+
+    for (int row = linesCleared; row <= bottom; ++row)
+        stats.hash ^= rowHash(row);
+
+    // Every column drops by the number of cleared rows, and further if its top block was cleared
+    stats.cellCount -= linesCleared * WIDTH;
+    for (int x = 0; x < WIDTH; ++x)
+    {
+        int height = stats.heights[x] - linesCleared;
+        Row bit = columnBit(x);
+        while (height > 0 && (rows[HEIGHT - height] & bit) == 0)
+            height--;
+        stats.heights[x] = static_cast<uint8_t>(height);
+    }
+    recomputeSurface();
+    return linesCleared;
+}
+
+// Places the piece and clears lines like placePiece + clearFullLines, journaling what changed
+template <int W, int H>
+int BasicBoard<W, H>::makeMove(const Tetromino &piece, Journal &journal)
+{
+    if (journal.depth == Journal::MAX_DEPTH)
+        return -1;
+
+    typename Journal::Entry &entry = journal.entries[journal.depth++];
+    entry.stats = stats;
+    entry.placedCount = 0;
+    for (const PieceShape::Cell &cell : piece.getShape().cells)
+    {
+        int x = piece.getX() + cell.x;
+        int y = piece.getY() + cell.y;
+        if (x >= 0 && x < WIDTH && y >= 0 && y < HEIGHT && cells[y][x] == ' ')
+            entry.placed[entry.placedCount++] = {static_cast<int8_t>(x), static_cast<int8_t>(y)};
+    }
+    placePiece(piece);
+
+    // Keep the rows that are about to be removed
+    entry.clearedCount = 0;
+    for (int y = stats.dirtyTop; y <= stats.dirtyBottom && entry.clearedCount < PieceShape::SIZE; ++y)
+    {
+        if (rowFill[y] == WIDTH)
+        {
+            entry.clearedY[entry.clearedCount] = static_cast<int8_t>(y);
+            std::memcpy(entry.clearedCells[entry.clearedCount], cells[y], sizeof(cells[y]));
+            entry.clearedCount++;
+        }
+    }
+    return clearFullLines();
+}
+
+// Reverses the most recent makeMove: puts the cleared rows back, then removes the piece
+template <int W, int H>
+void BasicBoard<W, H>::unmakeMove(Journal &journal)
+{
+    if (journal.depth == 0)
+        return;
+
+    const typename Journal::Entry &entry = journal.entries[--journal.depth];
+    int cleared = entry.clearedCount;
+    if (cleared > 0)
+    {
+        // Top-down, each surviving row comes back from (cleared rows below it) further down,
+        // which has not been overwritten yet; rows below the lowest cleared row never moved
+        int next = 0;
+        for (int y = 0; y <= entry.clearedY[cleared - 1]; ++y)
+        {
+            if (y == entry.clearedY[next])
             {
-                grid[0][col] = ' ';
+                rows[y] = FULL_ROW;
+                rowFill[y] = WIDTH;
+                std::memcpy(cells[y], entry.clearedCells[next], sizeof(cells[y]));
+                next++;
+                continue;
             }
-            linesCleared++;
+            int source = y + (cleared - next);
+            rows[y] = rows[source];
+            rowFill[y] = rowFill[source];
+            std::memcpy(cells[y], cells[source], sizeof(cells[y]));
         }
     }
-    return linesCleared;
+
+    for (int i = 0; i < entry.placedCount; ++i)
+    {
+        const PieceShape::Cell &cell = entry.placed[i];
+        rows[cell.y] &= static_cast<Row>(~columnBit(cell.x));
+        rowFill[cell.y]--;
+        cells[cell.y][cell.x] = ' ';
+    }
+    stats = entry.stats;
+}
+
+// Copies the whole board state; every size is a compile-time constant, so this is a few wide moves
+template <int W, int H>
+void BasicBoard<W, H>::save(Snapshot &snapshot) const
+{
+    std::memcpy(snapshot.rows, rows, sizeof(rows));
+    std::memcpy(snapshot.cells, cells, sizeof(cells));
+    std::memcpy(snapshot.rowFill, rowFill, sizeof(rowFill));
+    snapshot.stats = stats;
+}
+
+// Copies the saved state back
+template <int W, int H>
+void BasicBoard<W, H>::restore(const Snapshot &snapshot)
+{
+    std::memcpy(rows, snapshot.rows, sizeof(rows));
+    std::memcpy(cells, snapshot.cells, sizeof(cells));
+    std::memcpy(rowFill, snapshot.rowFill, sizeof(rowFill));
+    stats = snapshot.stats;
+}
+
+// Hashes the occupancy and piece identity of every cell (64-bit FNV-1a)
+template <int W, int H>
+uint64_t BasicBoard<W, H>::checksum() const
+{
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (int y = 0; y < HEIGHT; ++y)
+    {
+        for (size_t byte = 0; byte < sizeof(Row); ++byte) // Low byte first
+            hash = (hash ^ ((rows[y] >> (8 * byte)) & 0xFF)) * 0x100000001B3ull;
+        for (int x = 0; x < WIDTH; ++x)
+            hash = (hash ^ static_cast<uint8_t>(cells[y][x])) * 0x100000001B3ull;
+    }
+    return hash;
 }
 
 // Checks if a piece collides with the existing board (walls, floor, other blocks)
-bool Board::isCollision(const Tetromino &piece) const
+template <int W, int H>
+bool BasicBoard<W, H>::isCollision(const Tetromino &piece) const
 {
-    return piece.collidesWith(grid);
+    const PieceShape &shape = piece.getShape();
+    int x = piece.getX();
+    int y = piece.getY();
+
+    // Walls and floor are resolved from the bounding box alone
+    if (x + shape.minX < 0 || x + shape.maxX >= WIDTH || y + shape.maxY >= HEIGHT)
+    {
+        return true;
+    }
+
+    // Only the rows the piece occupies need to be tested against the placed blocks
+    int shift = x + WALL_BITS;
+    for (int dy = shape.minY; dy <= shape.maxY; ++dy)
+    {
+        if ((static_cast<Row>(Row(shape.rowMasks[dy]) << shift) & rowBits(y + dy)) != 0)
+        {
+            return true;
+        }
+    }
+    return false;
 }
 
 // Draws the board with borders, empty cells, and colored pieces
-void Board::drawBoard(const char grid[HEIGHT][WIDTH]) const
+template <int W, int H>
+void BasicBoard<W, H>::drawBoard(const char grid[HEIGHT][WIDTH]) const
 {
-    std::cout << COLOR_FRAME << "+--------------------+" << RESET_COLOR << "\n";
+    const std::string border = "+" + std::string(2 * WIDTH, '-') + "+";
+    std::cout << COLOR_FRAME << border << RESET_COLOR << "\n";
     for (int y = 0; y < HEIGHT; ++y)
     {
         std::cout << COLOR_FRAME << "|" << RESET_COLOR;
@@ -127,35 +479,42 @@ void Board::drawBoard(const char grid[HEIGHT][WIDTH]) const
             }
             else
             {
-                const char *color = RESET_COLOR;
-                switch (cell)
-                {
-                case 'I':
-                    color = COLOR_I;
-                    break;
-                case 'O':
-                    color = COLOR_O;
-                    break;
-                case 'T':
-                    color = COLOR_T;
-                    break;
-                case 'S':
-                    color = COLOR_S;
-                    break;
-                case 'Z':
-                    color = COLOR_Z;
-                    break;
-                case 'J':
-                    color = COLOR_J;
-                    break;
-                case 'L':
-                    color = COLOR_L;
-                    break;
-                }
-                std::cout << color << '#' << RESET_COLOR; // Colored hash for blocks
+                std::cout << cellColor(cell) << '#' << RESET_COLOR; // Colored hash for blocks
             }
         }
         std::cout << COLOR_FRAME << "|" << RESET_COLOR << "\n";
     }
-    std::cout << COLOR_FRAME << "+--------------------+" << RESET_COLOR << "\n";
+    std::cout << COLOR_FRAME << border << RESET_COLOR << "\n";
+}
+
+// Returns the color escape used for a cell holding the given piece character
+template <int W, int H>
+const char *BasicBoard<W, H>::cellColor(char cell)
+{
+    switch (cell)
+    {
+    case 'I':
+        return COLOR_I;
+    case 'O':
+        return COLOR_O;
+    case 'T':
+        return COLOR_T;
+    case 'S':
+        return COLOR_S;
+    case 'Z':
+        return COLOR_Z;
+    case 'J':
+        return COLOR_J;
+    case 'L':
+        return COLOR_L;
+    case ' ':
+        return COLOR_EMPTY;
+    }
+    return RESET_COLOR;
 }
+
+// The sizes declared in Board.h; another size only needs a line here
+template class BasicBoard<10, 20>;
+template class BasicBoard<10, 40>;
+template class BasicBoard<16, 20>;
+template class BasicBoard<32, 20>;
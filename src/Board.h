@@ -2,30 +2,85 @@
 #define BOARD_H
 
 #include "Tetromino.h"
+#include "Zobrist.h"
+#include <cstdint>
 #include <iostream>
+#include <type_traits>
 
-// Board class represents the 10x20 game grid
-class Board
+// Smallest unsigned type that holds a row of BITS bits (columns plus walls)
+template <int BITS>
+struct RowStorage
+{
+    static_assert(BITS <= 64, "rows are limited to 64 bits (58 columns)");
+    typedef typename std::conditional<BITS <= 16, uint16_t,
+                                      typename std::conditional<BITS <= 32, uint32_t, uint64_t>::type>::type type;
+};
+
+// BasicBoard is a W x H game grid. Every dimension, mask and loop bound is a compile-time constant
+// of the instantiation, so each size gets its own fully specialized code. The member functions are
+// defined in Board.cpp and explicitly instantiated there for the sizes listed at the end of this file.
+template <int W, int H>
+class BasicBoard
 {
 public:
-    static const int WIDTH = 10;  // Board width (fixed)
-    static const int HEIGHT = 20; // Board height (fixed)
+    static const int WIDTH = W;  // Board width
+    static const int HEIGHT = H; // Board height (including any hidden rows above the visible field)
 
-    Board(); // Constructor - initializes an empty board
+    // Each row is stored as a bitmask: bit (x + WALL_BITS) is set when column x is occupied.
+    // The padding bits on both sides (and any unused high bits) are always set and act as walls.
+    static const int WALL_BITS = 3;                                                           // Padding bits on each side of a row
+    typedef typename RowStorage<WIDTH + 2 * WALL_BITS>::type Row;                             // uint16_t, uint32_t or uint64_t, whichever fits
+    static constexpr Row FIELD_MASK = static_cast<Row>(((Row(1) << WIDTH) - 1) << WALL_BITS); // Bits covering the playable columns
+    static constexpr Row EMPTY_ROW = static_cast<Row>(~FIELD_MASK);                           // Empty row (walls only)
+    static constexpr Row FULL_ROW = static_cast<Row>(~Row(0));                                // Completely filled row
 
-    void clear();                                     // Clears the board (resetting to empty)
-    void draw(const Tetromino &currentPiece) const;   // Draws the board with current falling piece
-    bool movePiece(Tetromino &piece, int dx, int dy); // Attempts to move a piece, returns false if blocked
-    void rotatePiece(Tetromino &piece);               // Attempts to rotate the piece
-    void placePiece(const Tetromino &piece);          // Locks piece into the board when it lands
-    int clearFullLines();                             // Clears fully filled lines and returns how many were cleared
-    bool isCollision(const Tetromino &piece) const;   // Checks if piece collides with placed blocks
+    static_assert(HEIGHT <= 127, "cell coordinates are stored as int8_t");
 
-private:
-    char grid[HEIGHT][WIDTH]; // The internal 10x20 grid to store placed pieces
+    static constexpr Row columnBit(int x) { return static_cast<Row>(Row(1) << (x + WALL_BITS)); } // Bit of column x in a row
 
-    void drawBoard(const char grid[HEIGHT][WIDTH]) const; // Internal helper to render grid with borders/colors
+    BasicBoard(); // Constructor - initializes an empty board
+
+    void clear();                                           // Clears the board (resetting to empty)
+    void draw(const Tetromino &currentPiece) const;         // Draws the board with current falling piece
+    bool movePiece(Tetromino &piece, int dx, int dy) const; // Attempts to move a piece, returns false if blocked
+    bool rotatePiece(Tetromino &piece) const;               // Attempts to rotate the piece, returns false if blocked
+    void placePiece(const Tetromino &piece);                // Locks piece into the board when it lands
+    int clearFullLines();                                   // Clears fully filled lines and returns how many were cleared
+    bool isCollision(const Tetromino &piece) const;         // Checks if piece collides with placed blocks
+
+    // Row mask for collision checks; rows above the board are open except for the walls
+    Row rowBits(int y) const { return y < 0 ? EMPTY_ROW : rows[y]; }
+
+    char cellAt(int x, int y) const { return cells[y][x]; } // Piece character at (x, y), ' ' when empty
+    void fillCell(int x, int y, char pieceChar);           // Marks a single cell as occupied by the given piece
+
+    int dropDistance(const Tetromino &piece) const; // Rows the piece can fall before it lands (for hard drop)
+
+    // Surface statistics, kept up to date by fillCell and clearFullLines so they cost nothing to read
+    int columnHeight(int x) const { return stats.heights[x]; }               // Height of the topmost block in column x (0 = empty)
+    int rowFillCount(int y) const { return rowFill[y]; }                     // Occupied cells in row y
+    int getAggregateHeight() const { return stats.aggregateHeight; }         // Sum of all column heights
+    int getHoles() const { return stats.aggregateHeight - stats.cellCount; } // Empty cells below the top of their column
+    int getBumpiness() const { return stats.bumpiness; }                     // Sum of height differences between neighbouring columns
+    int getWellDepthSum() const { return stats.wellDepthSum; }               // Sum of wellDepth() over all columns
+    int wellDepth(int x) const;                                  // How far column x lies below both neighbours (walls count as full)
+
+    // Search support: make/unmake records just enough to undo a placement (see Journal below),
+    // snapshots save and restore the whole board
+    class Journal;
+    class Snapshot;
+    int makeMove(const Tetromino &piece, Journal &journal); // Places the piece and clears lines; returns lines cleared (-1 if the journal is full)
+    void unmakeMove(Journal &journal);                      // Undoes the most recent makeMove
+    void save(Snapshot &snapshot) const;                    // Copies the board into the snapshot
+    void restore(const Snapshot &snapshot);                 // Makes the board equal to the saved one
 
+    void copyCells(const Tetromino &piece, char out[HEIGHT][WIDTH]) const; // Copies the grid with the piece overlaid
+    uint64_t checksum() const;                                              // FNV-1a hash of rows and cells (for replays)
+    uint64_t hash() const { return stats.hash; }                            // Zobrist hash of the occupied cells, kept incrementally
+    uint64_t positionKey(const Tetromino &piece) const;                     // hash() combined with the piece type and rotation
+    static const char *cellColor(char cell);                                // Color escape for a cell character
+
+    // Terminal colors used when drawing the board
 #ifdef _WIN32
     static constexpr const char *RESET_COLOR = ""; // No color in Windows if ANSI not supported
     static constexpr const char *COLOR_I = "";
@@ -50,6 +105,116 @@ private:
     static constexpr const char *COLOR_FRAME = "\033[37m"; // White frame
     static constexpr const char *COLOR_EMPTY = "\033[90m"; // Gray empty cells
 #endif
+
+private:
+    Row rows[HEIGHT];          // Occupancy of each row as a bitmask (with wall padding)
+    char cells[HEIGHT][WIDTH]; // Piece identity of each cell, used only for coloring
+
+    // Cached statistics, grouped so that they can be saved and restored in one assignment
+    struct Stats
+    {
+        uint8_t heights[WIDTH]; // Column heights
+        int cellCount;          // Occupied cells on the whole board
+        int aggregateHeight;    // Sum of heights
+        int bumpiness;          // Sum of |heights[x] - heights[x + 1]|
+        int wellDepthSum;       // Sum of wellDepth(x)
+        int dirtyTop;           // Rows filled since the last clearFullLines() (empty range when top > bottom)
+        int dirtyBottom;
+        uint64_t hash;          // Zobrist hash (XOR of ZOBRIST.cells for every occupied cell)
+    };
+
+    static constexpr ZobristKeys<WIDTH, HEIGHT> ZOBRIST = makeZobristKeys<WIDTH, HEIGHT>(); // Keys for hash() and positionKey()
+
+    uint8_t rowFill[HEIGHT]; // Occupied cells per row
+    Stats stats;             // Column heights and the values derived from them
+
+    void setHeight(int x, int height);                 // Changes one column height and updates the surface statistics
+    void adjustSurface(int first, int last, int sign); // Adds (sign = 1) or removes (sign = -1) the terms that depend on columns first..last
+    uint64_t rowHash(int y) const;                     // XOR of the keys of the occupied cells in row y
+    void recomputeSurface();                           // Rebuilds aggregate height, bumpiness and wells from the heights
+
+    void drawBoard(const char grid[HEIGHT][WIDTH]) const; // Internal helper to render grid with borders/colors
 };
 
+// Undo stack for BasicBoard::makeMove. Entries are preallocated, so a search never allocates; each one
+// holds the cells the piece filled, the rows it cleared and the statistics from before the move.
+// A move must start from a board without pending full rows, which holds whenever every placement
+// is followed by clearFullLines (as in Engine and makeMove itself).
+template <int W, int H>
+class BasicBoard<W, H>::Journal
+{
+public:
+    static const int MAX_DEPTH = 32; // Moves that can be undone
+
+    Journal() : depth(0) {}
+
+    int getDepth() const { return depth; } // Moves currently recorded
+    void clear() { depth = 0; }           // Forgets all moves (the board keeps them)
+
+private:
+    friend class BasicBoard;
+
+    struct Entry
+    {
+        Stats stats;                                // Statistics before the move
+        PieceShape::Cell placed[PieceShape::SIZE];  // Board cells filled by the piece
+        int8_t placedCount;
+        int8_t clearedY[PieceShape::SIZE];          // Rows cleared, by their index before the clear (ascending)
+        char clearedCells[PieceShape::SIZE][WIDTH]; // Their contents
+        int8_t clearedCount;
+    };
+
+    Entry entries[MAX_DEPTH];
+    int depth;
+};
+
+// Saved copy of a Board's contents, for searches that would rather restore than undo move by move
+template <int W, int H>
+class BasicBoard<W, H>::Snapshot
+{
+private:
+    friend class BasicBoard;
+
+    Row rows[HEIGHT];
+    char cells[HEIGHT][WIDTH];
+    uint8_t rowFill[HEIGHT];
+    Stats stats;
+};
+
+// Sizes compiled in Board.cpp
+extern template class BasicBoard<10, 20>; // Standard field
+extern template class BasicBoard<10, 40>; // Standard field under a 20-row hidden spawn buffer
+extern template class BasicBoard<16, 20>; // Wide variants
+extern template class BasicBoard<32, 20>;
+
+typedef BasicBoard<10, 20> Board; // The board the game, bots and tools play on
+
+// Piece operations on any board size (declared in Tetromino.h)
+template <int W, int H>
+void Tetromino::draw(BasicBoard<W, H> &board) const
+{
+    char pieceChar = pieceChars[type];
+    for (const PieceShape::Cell &cell : shapes[type][rotation].cells)
+    {
+        int drawX = x + cell.x;
+        int drawY = y + cell.y;
+        if (drawX >= 0 && drawX < W && drawY >= 0 && drawY < H)
+        {
+            board.fillCell(drawX, drawY, pieceChar);
+        }
+    }
+}
+
+template <int W, int H>
+void Tetromino::placeOnBoard(BasicBoard<W, H> &board) const
+{
+    draw(board);
+}
+
+template <int W, int H>
+bool Tetromino::collidesWith(const BasicBoard<W, H> &board) const
+{
+    return board.isCollision(*this);
+}
+
 #endif
@@ -0,0 +1,301 @@
+#include "Broadcast.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Broadcast
+{
+    const uint32_t MAGIC = 0x43524254; // "TBRC"
+    const uint32_t VERSION = 1;
+
+    // Atomics in memory shared between processes must not fall back to a lock
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared counters need lock-free 64-bit atomics");
+
+    // One message. stamp is 2 * sequence + 1 while the writer fills the slot and 2 * sequence + 2 once
+    // it is complete.
+    struct alignas(64) Slot
+    {
+        std::atomic<uint64_t> stamp;
+        uint16_t size;
+        uint8_t data[Protocol::MAX_DELTA];
+    };
+
+    struct Region
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t slotCount;
+        uint32_t slotSize;
+        alignas(64) std::atomic<uint64_t> published; // Messages written so far (= sequence of the next one)
+        std::atomic<uint64_t> keyframe;              // Sequence of the latest complete keyframe
+        std::atomic<uint32_t> ended;                 // Set when the writer closes
+        Slot slots[SLOTS];
+    };
+
+    static_assert((SLOTS & (SLOTS - 1)) == 0, "the ring size must be a power of two");
+
+    // Shared memory objects are named "/name"
+    void objectName(const char *name, char *out, size_t size)
+    {
+        std::snprintf(out, size, "%s%s", name[0] == '/' ? "" : "/", name);
+    }
+}
+
+using namespace Broadcast;
+
+// Constructor - nothing is shared until open()
+BroadcastWriter::BroadcastWriter() : region(nullptr)
+{
+    name[0] = '\0';
+}
+
+// Destructor - ends the broadcast if it is still open
+BroadcastWriter::~BroadcastWriter()
+{
+    close();
+}
+
+// Constructor - attach() picks the broadcast to follow
+BroadcastReader::BroadcastReader() : region(nullptr), next(0), complete(false), resync(true)
+{
+}
+
+// Destructor - unmaps the ring
+BroadcastReader::~BroadcastReader()
+{
+    detach();
+}
+
+#ifndef _WIN32
+
+// Creates a fresh zero-filled ring under name, replacing any left by an earlier game, and
+// publishes its header last
+bool BroadcastWriter::open(const char *broadcastName)
+{
+    close();
+    objectName(broadcastName, name, sizeof(name));
+    shm_unlink(name); // Viewers still attached to an old ring keep their mapping
+
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0)
+        return false;
+    void *memory = MAP_FAILED;
+    if (ftruncate(fd, sizeof(Region)) == 0)
+        memory = mmap(nullptr, sizeof(Region), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED)
+    {
+        shm_unlink(name);
+        return false;
+    }
+
+    // The new object is zero-filled: no slot is stamped and nothing is published
+    region = static_cast<Region *>(memory);
+    region->slotCount = SLOTS;
+    region->slotSize = sizeof(Slot);
+    region->version = VERSION;
+    std::atomic_thread_fence(std::memory_order_release);
+    region->magic = MAGIC; // Last, so a reader that sees it sees a complete header
+
+    Protocol::clear(last);
+    stats = Stats();
+    return true;
+}
+
+// Marks the broadcast ended for attached viewers, then unmaps and removes the ring
+void BroadcastWriter::close()
+{
+    if (region == nullptr)
+        return;
+    region->ended.store(1, std::memory_order_release);
+    munmap(region, sizeof(Region));
+    shm_unlink(name); // Attached viewers keep their mapping until they detach
+    region = nullptr;
+}
+
+// Constant work per frame: capture, compare, encode into the next slot. Keyframes are due by count,
+// so a viewer never waits longer than KEYFRAME_INTERVAL messages for a place to start.
+void BroadcastWriter::publish(const Engine &engine)
+{
+    Protocol::Screen screen;
+    Protocol::capture(engine, screen);
+    uint64_t sequence = region->published.load(std::memory_order_relaxed); // Only this process writes it
+    bool keyframe = sequence % KEYFRAME_INTERVAL == 0;
+    if (!keyframe && Protocol::same(screen, last))
+        return;
+
+    Slot &slot = region->slots[sequence & (SLOTS - 1)];
+    slot.stamp.store(2 * sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release); // The odd stamp is visible before any new data
+    size_t size = Protocol::encodeDelta(last, screen, 0, keyframe, slot.data);
+    slot.size = static_cast<uint16_t>(size);
+    slot.stamp.store(2 * sequence + 2, std::memory_order_release);
+    if (keyframe)
+        region->keyframe.store(sequence, std::memory_order_release);
+    region->published.store(sequence + 1, std::memory_order_release);
+
+    last = screen;
+    stats.messages++;
+    stats.keyframes += keyframe ? 1 : 0;
+    stats.bytes += static_cast<long long>(size);
+}
+
+// Maps an existing ring read-only and checks that it was written by this layout; the first poll()
+// starts from the latest keyframe
+bool BroadcastReader::attach(const char *broadcastName)
+{
+    detach();
+    char name[256];
+    objectName(broadcastName, name, sizeof(name));
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0)
+        return false;
+    struct stat info;
+    void *memory = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) == sizeof(Region))
+        memory = mmap(nullptr, sizeof(Region), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED)
+        return false;
+
+    region = static_cast<const Region *>(memory);
+    if (region->magic != MAGIC || region->version != VERSION || region->slotCount != SLOTS ||
+        region->slotSize != sizeof(Slot))
+    {
+        detach(); // Written by a different build
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    next = 0;
+    complete = false;
+    resync = true;
+    stats = Stats();
+    return true;
+}
+
+// Unmaps the ring (the writer and other viewers are not affected)
+void BroadcastReader::detach()
+{
+    if (region == nullptr)
+        return;
+    munmap(const_cast<Region *>(region), sizeof(Region));
+    region = nullptr;
+}
+
+// Applies every delta published since the last call to screen. Falls back to the latest keyframe
+// when too far behind or when a slot was overwritten mid-read, retrying a few times before leaving
+// the rest to the next call. False once the broadcast has ended and everything has been applied.
+bool BroadcastReader::poll(Protocol::Screen &screen)
+{
+    bool ended = region->ended.load(std::memory_order_acquire) != 0;
+    uint64_t published = region->published.load(std::memory_order_acquire);
+    if (published == 0)
+        return !ended; // Nothing to show yet
+
+    stats.lag = static_cast<long>(published - next);
+    if (stats.lag > stats.maxLag)
+        stats.maxLag = stats.lag;
+    if (resync || published - next > static_cast<uint64_t>(LAG_LIMIT))
+        jumpToKeyframe();
+
+    uint8_t message[Protocol::MAX_DELTA];
+    int attempts = 0;
+    while (next < published)
+    {
+        size_t size = 0;
+        uint16_t ack = 0;
+        uint8_t flags = 0;
+        Protocol::Screen updated = screen;
+        bool ok = read(next, message, size) && Protocol::applyDelta(message, size, updated, ack, flags) &&
+                  (!resync || (flags & Protocol::KEYFRAME));
+        if (!ok)
+        {
+            if (++attempts > 3)
+                break; // The writer keeps lapping us; try again on the next poll
+            jumpToKeyframe(); // Overwritten while we were behind
+            continue;
+        }
+        screen = updated;
+        complete = true;
+        resync = false;
+        stats.applied++;
+        next++;
+    }
+    return !ended || next < region->published.load(std::memory_order_acquire);
+}
+
+// Seqlock read: the copy is only trusted if the stamp was complete and unchanged around it
+bool BroadcastReader::read(uint64_t sequence, uint8_t *out, size_t &size) const
+{
+    const Slot &slot = region->slots[sequence & (SLOTS - 1)];
+    uint64_t stamp = slot.stamp.load(std::memory_order_acquire);
+    if (stamp != 2 * sequence + 2)
+        return false;
+    size = slot.size;
+    if (size > Protocol::MAX_DELTA)
+        return false;
+    std::memcpy(out, slot.data, size);
+    std::atomic_thread_fence(std::memory_order_acquire); // The copy completes before the stamp is checked again
+    return slot.stamp.load(std::memory_order_relaxed) == stamp;
+}
+
+// Resync: continues from the latest keyframe and counts the deltas skipped to get there
+void BroadcastReader::jumpToKeyframe()
+{
+    uint64_t keyframe = region->keyframe.load(std::memory_order_acquire);
+    if (complete)
+    {
+        stats.skips++;
+        if (keyframe > next)
+            stats.dropped += static_cast<long>(keyframe - next);
+    }
+    next = keyframe;
+    resync = true; // The next delta applied must be this keyframe
+}
+
+#else
+
+// Reports that broadcasting is unavailable without POSIX shared memory
+bool BroadcastWriter::open(const char *)
+{
+    std::cerr << "Broadcasting needs POSIX shared memory (Linux/macOS)\n";
+    return false;
+}
+
+// Nothing to close: open() never succeeds here
+void BroadcastWriter::close()
+{
+}
+
+// Nothing is published without a ring
+void BroadcastWriter::publish(const Engine &)
+{
+}
+
+// Reports that watching is unavailable without POSIX shared memory
+bool BroadcastReader::attach(const char *)
+{
+    std::cerr << "Watching needs POSIX shared memory (Linux/macOS)\n";
+    return false;
+}
+
+// Nothing to unmap: attach() never succeeds here
+void BroadcastReader::detach()
+{
+}
+
+// Never attached, so there is nothing to follow
+bool BroadcastReader::poll(Protocol::Screen &)
+{
+    return false;
+}
+
+#endif
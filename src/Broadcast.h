@@ -0,0 +1,98 @@
+#ifndef BROADCAST_H
+#define BROADCAST_H
+
+#include "Engine.h"
+#include "Protocol.h"
+#include <cstddef>
+#include <cstdint>
+
+// A broadcast is a ring of Protocol deltas in POSIX shared memory: one game writes every frame that
+// changed, and any number of viewer processes map the same memory read-only and replay the deltas
+// at their own pace. The writer never looks at its viewers, so its cost per frame is the same with
+// one viewer or a hundred, and a stalled viewer can never hold the game up.
+//
+// Each slot carries a sequence stamp that is odd while the writer fills it (a seqlock), so a reader
+// can tell a complete message from one being overwritten. A keyframe is published at a fixed
+// interval; a reader that falls too far behind, or finds its next slot already reused, jumps to the
+// latest keyframe and counts the deltas it skipped.
+//
+// Linux/macOS only; on Windows open() and attach() report that broadcasting is unavailable.
+namespace Broadcast
+{
+    const int SLOTS = 1024;                              // Messages kept in the ring (a power of two)
+    const int KEYFRAME_INTERVAL = 32;                    // A keyframe every this many messages
+    const int LAG_LIMIT = SLOTS - 2 * KEYFRAME_INTERVAL; // Readers further behind skip to the latest keyframe
+
+    struct Region; // Shared layout (see Broadcast.cpp)
+}
+
+// Publishes the frames of one game
+class BroadcastWriter
+{
+public:
+    struct Stats
+    {
+        long messages = 0;   // Deltas published
+        long keyframes = 0;  // ... of which keyframes
+        long long bytes = 0; // Delta bytes published
+    };
+
+    BroadcastWriter();
+    ~BroadcastWriter();
+
+    BroadcastWriter(const BroadcastWriter &) = delete;
+    BroadcastWriter &operator=(const BroadcastWriter &) = delete;
+
+    bool open(const char *name);        // Creates (or replaces) the shared ring called name
+    void close();                       // Tells viewers the broadcast ended and removes the ring
+    void publish(const Engine &engine); // Publishes the current frame if anything changed since the last one
+    bool isOpen() const { return region != nullptr; }
+    const Stats &getStats() const { return stats; }
+
+private:
+    Broadcast::Region *region;
+    char name[256];
+    Protocol::Screen last; // Frame the last delta led to
+    Stats stats;
+};
+
+// Follows a broadcast from another process
+class BroadcastReader
+{
+public:
+    struct Stats
+    {
+        long applied = 0; // Deltas applied
+        long dropped = 0; // Deltas never applied because the reader jumped over them
+        long skips = 0;   // Jumps to a keyframe
+        long lag = 0;     // Deltas that were waiting at the last poll()
+        long maxLag = 0;  // Largest lag seen
+    };
+
+    BroadcastReader();
+    ~BroadcastReader();
+
+    BroadcastReader(const BroadcastReader &) = delete;
+    BroadcastReader &operator=(const BroadcastReader &) = delete;
+
+    bool attach(const char *name); // Maps the ring read-only
+    void detach();
+
+    // Brings screen up to date with everything published so far; false once the broadcast has ended.
+    // Until the first keyframe arrives, hasFrame() stays false and screen is left alone.
+    bool poll(Protocol::Screen &screen);
+    bool hasFrame() const { return complete; }
+    const Stats &getStats() const { return stats; }
+
+private:
+    const Broadcast::Region *region;
+    uint64_t next; // Sequence of the next delta to apply
+    bool complete; // Whether the caller's screen holds a complete frame
+    bool resync;   // The next delta applied must be a keyframe
+    Stats stats;
+
+    bool read(uint64_t sequence, uint8_t *out, size_t &size) const; // Copies a complete message; false if overwritten
+    void jumpToKeyframe();
+};
+
+#endif
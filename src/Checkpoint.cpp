@@ -0,0 +1,166 @@
+#include "Checkpoint.h"
+#include "Engine.h"
+#include "Policy.h"
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+// Written and read as raw bytes, so the layout may not contain implicit padding
+static_assert(sizeof(Checkpoint) == 8 + sizeof(Randomizer::State) + 8 * 9 + 4 * 3 + 8 + Board::HEIGHT * Board::WIDTH + 4,
+              "the checkpoint layout has padding");
+static_assert(sizeof(Randomizer::State) == 8 + 3 + 7 + Randomizer::PREVIEW, "the randomizer state has padding");
+
+namespace
+{
+    // FNV-1a over the bytes before the checksum field
+    uint32_t checksumOf(const Checkpoint &checkpoint)
+    {
+        const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&checkpoint);
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < offsetof(Checkpoint, checksum); ++i)
+            hash = (hash ^ bytes[i]) * 16777619u;
+        return hash;
+    }
+}
+
+// Stamps the header and computes the checksum over everything else
+void Checkpoint::seal()
+{
+    magic = MAGIC;
+    version = VERSION;
+    size = sizeof(Checkpoint);
+    checksum = checksumOf(*this);
+}
+
+// Header of this version and layout, and a checksum that still matches
+bool Checkpoint::isSealed() const
+{
+    return magic == MAGIC && version == VERSION && size == sizeof(Checkpoint) && checksum == checksumOf(*this);
+}
+
+// Writes to path + ".tmp" and renames it over path once it is complete and synced, so a crash or a
+// full disk during a save leaves the previous checkpoint in place
+bool Checkpoint::write(const char *path) const
+{
+    std::string temporary = std::string(path) + ".tmp";
+    std::FILE *file = std::fopen(temporary.c_str(), "wb");
+    if (file == nullptr)
+        return false;
+    bool ok = std::fwrite(this, sizeof(Checkpoint), 1, file) == 1 && std::fflush(file) == 0;
+#ifndef _WIN32
+    ok = ok && fsync(fileno(file)) == 0;
+#endif
+    ok = std::fclose(file) == 0 && ok;
+#ifdef _WIN32
+    if (ok)
+        std::remove(path); // rename() does not replace an existing file on Windows
+#endif
+    if (!ok || std::rename(temporary.c_str(), path) != 0)
+    {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Reads exactly one struct and checks its seal; the fields are checked by Engine::restore
+bool Checkpoint::read(const char *path)
+{
+    std::FILE *file = std::fopen(path, "rb");
+    if (file == nullptr)
+        return false;
+    bool ok = std::fread(this, sizeof(Checkpoint), 1, file) == 1 && std::fgetc(file) == EOF; // Exactly one struct
+    std::fclose(file);
+    return ok && isSealed();
+}
+
+// Round trip at the start, lockstep from a halfway checkpoint, and the same final state
+bool Checkpoint::verifyFuture(const Engine &engine, unsigned seed, long frames)
+{
+    // Saving a restored game gives back the same bytes
+    Checkpoint saved;
+    Checkpoint again;
+    Engine restored;
+    engine.save(saved);
+    if (!restored.restore(saved))
+        return false;
+    restored.save(again);
+    if (std::memcmp(&saved, &again, sizeof(Checkpoint)) != 0)
+        return false;
+
+    // Play the first half, then continue the original and a copy restored from a checkpoint in lockstep
+    RandomPolicy policy;
+    policy.reset(seed);
+    Engine original = engine;
+    long frame = 0;
+    for (; frame < frames / 2 && !original.isGameOver(); ++frame)
+        original.step(policy.chooseActions(original));
+
+    Checkpoint halfway;
+    original.save(halfway);
+    Engine copy;
+    if (!copy.restore(halfway))
+        return false;
+    for (; frame < frames && !original.isGameOver(); ++frame)
+    {
+        unsigned actions = policy.chooseActions(original);
+        Engine::StepResult expected = original.step(actions);
+        Engine::StepResult result = copy.step(actions);
+        if (result.events != expected.events || result.lines != expected.lines ||
+            copy.getBoard().hash() != original.getBoard().hash())
+            return false;
+    }
+
+    // Every field agrees at the end, the randomizer included
+    original.save(saved);
+    copy.save(again);
+    return std::memcmp(&saved, &again, sizeof(Checkpoint)) == 0;
+}
+
+// Seeded games (uniform and bag randomizers alternating) checked at increasing depths, the last
+// one usually after the game has ended
+int Checkpoint::verifyGames(unsigned seed, int games)
+{
+    static const long DEPTHS[] = {0, 60, 400, 1500, 6000}; // Frames played before each check
+    int positions = 0;
+    for (int game = 0; game < games; ++game)
+    {
+        Engine engine(seed + game, game % 2 == 0 ? Randomizer::UNIFORM : Randomizer::BAG);
+        RandomPolicy policy;
+        policy.reset(seed + game);
+        for (long depth : DEPTHS)
+        {
+            while (engine.getFrame() < depth && !engine.isGameOver())
+                engine.step(policy.chooseActions(engine));
+
+            // A fresh engine restored from the saved bytes must have the original's future
+            Checkpoint saved;
+            Engine restored;
+            engine.save(saved);
+            if (!restored.restore(saved) || !verifyFuture(engine, seed + game, 2000))
+                return -1;
+            Engine original = engine;
+            RandomPolicy inputs;
+            inputs.reset(seed + game + 1);
+            for (long frame = 0; frame < 2000 && !original.isGameOver(); ++frame)
+            {
+                unsigned actions = inputs.chooseActions(original);
+                original.step(actions);
+                restored.step(actions);
+            }
+            Checkpoint expected;
+            Checkpoint actual;
+            original.save(expected);
+            restored.save(actual);
+            if (std::memcmp(&expected, &actual, sizeof(Checkpoint)) != 0)
+                return -1;
+            positions++;
+        }
+    }
+    return positions;
+}
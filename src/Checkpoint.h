@@ -0,0 +1,59 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "Board.h"
+#include "Randomizer.h"
+#include <cstdint>
+
+class Engine;
+
+// Checkpoint file: one Checkpoint struct written as is (native byte order, no padding).
+//   "TCKP", version (u16), size (u16), randomizer state, frame, pieces placed, pieces by type,
+//   score, level, lines, board size, falling piece, game-over flag, board cells, checksum (u32)
+//
+// A checkpoint is the complete state of an Engine, randomizer included, so a restored game plays
+// on exactly as the saved one would have. It is read and written with a single copy; the header,
+// the checksum and the consistency of every field are checked before an Engine takes it over.
+struct Checkpoint
+{
+    static const uint32_t MAGIC = 0x504b4354; // "TCKP"
+    static const uint16_t VERSION = 1;
+
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size; // sizeof(Checkpoint), so a file of a different layout is rejected
+    Randomizer::State randomizer;
+    int64_t frame;
+    int64_t piecesPlaced;
+    int64_t piecesOfType[7]; // By Tetromino::Type
+    int32_t score;
+    int32_t level;
+    int32_t linesCleared;
+    uint8_t width; // Board size the cells were saved from
+    uint8_t height;
+    uint8_t pieceType; // Falling piece
+    uint8_t pieceRotation;
+    int8_t pieceX;
+    int8_t pieceY;
+    uint8_t gameOver;
+    uint8_t reserved;
+    char cells[Board::HEIGHT][Board::WIDTH]; // Locked cells only (' ' = empty)
+    uint32_t checksum;                       // FNV-1a of every byte before it
+
+    void seal();                        // Fills in the header and checksum
+    bool isSealed() const;              // Whether the header and checksum are intact
+    bool write(const char *path) const; // Writes the file; false on any error
+    bool read(const char *path);        // Reads and checks the file; false if missing, short or damaged
+
+    // Determinism check: plays engine on with random inputs for up to frames frames, checkpoints it
+    // halfway, restores that checkpoint into a second engine and feeds it the same inputs. True if
+    // the round trip is exact and both games end in the same state.
+    static bool verifyFuture(const Engine &engine, unsigned seed, long frames);
+
+    // Self-check that needs no saved file: plays games seeded from seed, and at several depths of
+    // each saves, restores into a fresh Engine and runs verifyFuture. Returns the number of positions
+    // checked, or -1 at the first one that fails.
+    static int verifyGames(unsigned seed, int games);
+};
+
+#endif
@@ -0,0 +1,217 @@
+#include "Engine.h"
+#include <algorithm>
+
+// Constructor - initialize game state and prepare first piece
+Engine::Engine(unsigned seed, Randomizer::Mode mode) : currentPiece(Tetromino::I), randomizer(seed, mode)
+{
+    reset(seed);
+}
+
+// Reset all gameplay variables for a fresh game
+void Engine::reset(unsigned seed)
+{
+    StepResult ignored = {0, 0};
+    randomizer.reset(seed, randomizer.getMode());
+    board.clear();
+    score = 0;
+    level = 1;
+    linesCleared = 0;
+    piecesPlaced = 0;
+    for (long &count : piecesOfType)
+        count = 0;
+    frameCounter = 0;
+    gameOver = false;
+    spawnPiece(ignored);
+}
+
+// Handle movement and rotation for this frame
+Engine::StepResult Engine::input(unsigned actions)
+{
+    StepResult result = {0, 0};
+    if (gameOver)
+        return result;
+
+    if (actions & MOVE_LEFT)
+    {
+        board.movePiece(currentPiece, -1, 0);
+    }
+
+    if (actions & MOVE_RIGHT)
+    {
+        board.movePiece(currentPiece, 1, 0);
+    }
+
+    if (actions & SOFT_DROP)
+    {
+        board.movePiece(currentPiece, 0, 1);
+    }
+
+    if (actions & ROTATE)
+    {
+        board.rotatePiece(currentPiece);
+    }
+
+    if (actions & HARD_DROP)
+    { // Hard drop (instantly falls to bottom)
+        currentPiece.move(0, board.dropDistance(currentPiece));
+        lockPiece(result);
+    }
+    return result;
+}
+
+// Apply gravity at regular intervals (depends on level)
+Engine::StepResult Engine::tick()
+{
+    StepResult result = {0, 0};
+    if (gameOver)
+        return result;
+
+    if (frameCounter % gravityInterval() == 0 && !board.movePiece(currentPiece, 0, 1))
+    {
+        lockPiece(result); // Piece lands if blocked
+    }
+    frameCounter++;
+    return result;
+}
+
+// Number of tick() calls before the one that applies gravity (0 = the next tick does)
+int Engine::getFramesUntilGravity() const
+{
+    int interval = gravityInterval();
+    return static_cast<int>((interval - frameCounter % interval) % interval);
+}
+
+// Frames per gravity step at the current level
+int Engine::gravityInterval() const
+{
+    return std::max(1, BASE_GRAVITY_INTERVAL - level);
+}
+
+// Runs one full frame of input and gravity
+Engine::StepResult Engine::step(unsigned actions)
+{
+    StepResult result = input(actions);
+    StepResult gravity = tick();
+    result.events |= gravity.events;
+    result.lines += gravity.lines;
+    return result;
+}
+
+// Captures the whole game, randomizer included, as a sealed checkpoint
+void Engine::save(Checkpoint &checkpoint) const
+{
+    checkpoint = Checkpoint(); // Zero, reserved bytes included
+    randomizer.save(checkpoint.randomizer);
+    checkpoint.frame = frameCounter;
+    checkpoint.piecesPlaced = piecesPlaced;
+    for (int type = 0; type < 7; ++type)
+        checkpoint.piecesOfType[type] = piecesOfType[type];
+    checkpoint.score = score;
+    checkpoint.level = level;
+    checkpoint.linesCleared = linesCleared;
+    checkpoint.width = Board::WIDTH;
+    checkpoint.height = Board::HEIGHT;
+    checkpoint.pieceType = static_cast<uint8_t>(currentPiece.getType());
+    checkpoint.pieceRotation = static_cast<uint8_t>(currentPiece.getRotation());
+    checkpoint.pieceX = static_cast<int8_t>(currentPiece.getX());
+    checkpoint.pieceY = static_cast<int8_t>(currentPiece.getY());
+    checkpoint.gameOver = gameOver ? 1 : 0;
+    for (int y = 0; y < Board::HEIGHT; ++y)
+        for (int x = 0; x < Board::WIDTH; ++x)
+            checkpoint.cells[y][x] = board.cellAt(x, y);
+    checkpoint.seal();
+}
+
+// Everything is checked and rebuilt on the side first, so a bad checkpoint leaves the game as it was
+bool Engine::restore(const Checkpoint &checkpoint)
+{
+    if (!checkpoint.isSealed() || checkpoint.width != Board::WIDTH || checkpoint.height != Board::HEIGHT ||
+        checkpoint.pieceType >= 7 || checkpoint.pieceRotation >= 4 || checkpoint.score < 0 || checkpoint.level < 1 ||
+        checkpoint.linesCleared < 0 || checkpoint.frame < 0 || checkpoint.piecesPlaced < 0)
+        return false;
+
+    // The board's masks, heights and hash are derived from the cells as they are filled in
+    Board restored;
+    for (int y = 0; y < Board::HEIGHT; ++y)
+    {
+        int filled = 0;
+        for (int x = 0; x < Board::WIDTH; ++x)
+        {
+            char cell = checkpoint.cells[y][x];
+            if (cell == ' ')
+                continue;
+            bool known = false;
+            for (int type = 0; type < 7; ++type)
+                known |= cell == Tetromino::typeChar(static_cast<Tetromino::Type>(type));
+            if (!known)
+                return false;
+            restored.fillCell(x, y, cell);
+            filled++;
+        }
+        if (filled == Board::WIDTH)
+            return false; // Full rows are always cleared when a piece locks
+    }
+    restored.clearFullLines(); // Clears nothing; resets the rows it checks after the next lock
+
+    Tetromino piece(static_cast<Tetromino::Type>(checkpoint.pieceType));
+    piece.setPosition(checkpoint.pieceX, checkpoint.pieceY);
+    for (int i = 0; i < checkpoint.pieceRotation; ++i)
+        piece.rotate();
+    if (!checkpoint.gameOver && restored.isCollision(piece))
+        return false; // Only a piece that could not spawn overlaps the board
+
+    Randomizer sequence;
+    if (!sequence.restore(checkpoint.randomizer))
+        return false;
+
+    board = restored;
+    currentPiece = piece;
+    randomizer = sequence;
+    score = checkpoint.score;
+    level = checkpoint.level;
+    linesCleared = checkpoint.linesCleared;
+    piecesPlaced = checkpoint.piecesPlaced;
+    for (int type = 0; type < 7; ++type)
+        piecesOfType[type] = checkpoint.piecesOfType[type];
+    frameCounter = checkpoint.frame;
+    gameOver = checkpoint.gameOver != 0;
+    return true;
+}
+
+// Spawns the next piece from the randomizer at starting position (top-center)
+void Engine::spawnPiece(StepResult &result)
+{
+    currentPiece = Tetromino(randomizer.next());
+    currentPiece.setPosition(Board::WIDTH / 2 - 1, 0);
+    if (board.isCollision(currentPiece))
+    { // Collision immediately = game over
+        gameOver = true;
+        result.events |= GAME_OVER;
+    }
+}
+
+// Handles logic when a piece lands (scoring, clearing lines, leveling up)
+void Engine::lockPiece(StepResult &result)
+{
+    board.placePiece(currentPiece);     // Lock piece into grid
+    int lines = board.clearFullLines(); // Clear any full rows
+    piecesPlaced++;
+    piecesOfType[currentPiece.getType()]++;
+    result.events |= PIECE_LOCKED;
+
+    if (lines > 0)
+    {
+        linesCleared += lines;            // Track cleared lines
+        score += lines * POINTS_PER_LINE; // Score 100 points per line
+        result.events |= LINES_CLEARED;
+        result.lines += lines;
+    }
+
+    if (linesCleared >= level * LINES_PER_LEVEL)
+    { // Increase level after every 3 cleared lines
+        level++;
+        result.events |= LEVEL_UP;
+    }
+
+    spawnPiece(result); // New piece starts falling
+}
@@ -0,0 +1,89 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include "Board.h"
+#include "Checkpoint.h"
+#include "Randomizer.h"
+#include "Tetromino.h"
+
+// Engine holds the game rules (board, falling piece, score, level) with no I/O and no sleeping,
+// so the same rules can drive the interactive Game or run headless as fast as the CPU allows
+class Engine
+{
+public:
+    // Player actions for a single frame (combined as a bitmask)
+    enum Action
+    {
+        MOVE_LEFT = 1 << 0,  // Move left
+        MOVE_RIGHT = 1 << 1, // Move right
+        SOFT_DROP = 1 << 2,  // Move down one row
+        ROTATE = 1 << 3,     // Rotate clockwise
+        HARD_DROP = 1 << 4   // Drop to the bottom and lock
+    };
+
+    // Events reported back to the caller (combined as a bitmask)
+    enum Event
+    {
+        PIECE_LOCKED = 1 << 0,  // A piece was locked into the board
+        LINES_CLEARED = 1 << 1, // One or more lines were cleared
+        LEVEL_UP = 1 << 2,      // The level increased
+        GAME_OVER = 1 << 3      // The new piece could not be spawned
+    };
+
+    // Rules shared with other simulators (VecEnv)
+    static const int BASE_GRAVITY_INTERVAL = 6; // Frames per gravity step at level 0 (lower = faster)
+    static const int POINTS_PER_LINE = 100;     // Score awarded for each cleared line
+    static const int LINES_PER_LEVEL = 3;       // Level increases after every 3 cleared lines
+
+    // Outcome of input(), tick() or step()
+    struct StepResult
+    {
+        unsigned events; // Bitmask of Event values
+        int lines;       // Lines cleared during the call
+    };
+
+    explicit Engine(unsigned seed = 0, Randomizer::Mode mode = Randomizer::UNIFORM); // Constructor - starts a fresh game
+
+    void reset(unsigned seed); // Resets the board, score and level for a new game (same randomizer mode)
+
+    StepResult input(unsigned actions); // Applies the player's actions for the current frame
+    StepResult tick();                  // Advances one frame (gravity, locking)
+    StepResult step(unsigned actions);  // Runs a whole frame: input() followed by tick()
+
+    // Read-only view of the game state
+    const Board &getBoard() const { return board; }
+    const Tetromino &getCurrentPiece() const { return currentPiece; }
+    Tetromino::Type getNextPiece(int index) const { return randomizer.peek(index); } // Preview, index < Randomizer::PREVIEW
+    int getScore() const { return score; }
+    int getLevel() const { return level; }
+    int getLinesCleared() const { return linesCleared; }
+    long getPiecesPlaced() const { return piecesPlaced; }
+    long getPiecesOfType(Tetromino::Type type) const { return piecesOfType[type]; } // Pieces of one type locked so far
+    long getFrame() const { return frameCounter; }
+    int getFramesUntilGravity() const; // Ticks left before the piece next falls on its own
+    Randomizer::Mode getRandomizerMode() const { return randomizer.getMode(); }
+    bool isGameOver() const { return gameOver; }
+
+    // Checkpoints (see Checkpoint.h)
+    void save(Checkpoint &checkpoint) const;    // Copies out the whole game state, sealed
+    bool restore(const Checkpoint &checkpoint); // Takes over a saved game; false (engine unchanged) if it is damaged or inconsistent
+
+private:
+    Board board;            // The game board
+    Tetromino currentPiece; // The currently falling piece
+    Randomizer randomizer;  // Piece sequence owned by this game, so games never share random state
+
+    int score;            // Player's score
+    int level;            // Current game level
+    int linesCleared;     // Total lines cleared so far
+    long piecesPlaced;    // Pieces locked into the board so far
+    long piecesOfType[7]; // ... by Tetromino::Type
+    long frameCounter;    // Frames simulated since the game started
+    bool gameOver;        // Set once a new piece collides on spawn
+
+    int gravityInterval() const;         // Frames per gravity step at the current level
+    void spawnPiece(StepResult &result); // Spawn a new tetromino, flagging game over if it is blocked
+    void lockPiece(StepResult &result);  // Lock the piece, clear lines, score and spawn the next one
+};
+
+#endif
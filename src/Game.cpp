@@ -1,34 +1,43 @@
 #include "Game.h"
+#include "Profiler.h"
 #include <iostream>
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <ctime>
 
-// Platform-specific screen clearing and sleep functions
-#ifdef _WIN32
-#include <windows.h>
-#define CLEAR_SCREEN "cls"
-#define SLEEP_MS(ms) Sleep(ms)
-#else
-#include <unistd.h>
-#define CLEAR_SCREEN "clear"
-#define SLEEP_MS(ms) usleep((ms) * 1000)
-#endif
-
-// Constructor - initialize game state and prepare first piece
-Game::Game() : score(0), level(1), linesCleared(0), highScore(0),
-               gameOver(false), paused(false), exitGame(false),
-               currentPiece(Tetromino::getRandomPiece()) {}
+// Constructor - initialize session state
+Game::Game(const GameOptions &options)
+    : engine(0, options.randomizer), renderThread(renderer), options(options), clock(FRAME_MS), highScore(0), paused(false), exitGame(false), resumed(false), showOverlay(false)
+{
+    message[0] = '\0';
+    if (options.autoplay)
+    {
+        pool.reset(new ThreadPool(options.threads));
+        autoPlayer.reset(new AutoPlayer(options.autoPlayer, pool.get()));
+    }
+    if (options.broadcast != nullptr && !broadcast.open(options.broadcast))
+        std::cerr << "Could not start the broadcast " << options.broadcast << "\n";
+    if (options.scoreFile != nullptr && scores.open(options.scoreFile))
+    {
+        highScore = scores.getSummary().highScore; // The record to beat survives restarts
+        if (scores.getOpenStats().recovered)
+            std::cerr << "Recovered " << options.scoreFile << ": dropped " << scores.getOpenStats().droppedBytes
+                      << " bytes of an incomplete record\n";
+    }
+}
 
 // Main function - runs the entire game lifecycle
 void Game::run()
 {
-    srand(time(nullptr)); // Seed random generator
     while (!exitGame)
     {
         initialize();         // Set up game state for new game
         gameLoop();           // Main gameplay loop
+        saveReplay();         // Keep the game for later analysis
+        saveScore();          // Add it to the lifetime statistics
         showGameOverScreen(); // Show final score
-        if (!promptRestart())
+        if (exitGame || !promptRestart())
             break; // Ask if player wants to restart
     }
 }
@@ -36,60 +45,108 @@ void Game::run()
 // Reset all gameplay variables for a fresh game
 void Game::initialize()
 {
-    board.clear();
-    spawnPiece(); // Start with first piece
-    score = 0;
-    level = 1;
-    linesCleared = 0;
-    gameOver = false;
+    unsigned seed = static_cast<unsigned>(time(nullptr));
+    engine.reset(seed); // Seed the piece generator
+    replay.begin(seed, engine.getRandomizerMode());
+    if (autoPlayer)
+        autoPlayer->reset(seed);
     paused = false;
+    resumed = false;
+    message[0] = '\0';
 }
 
 // Main gameplay loop - runs until game over
 void Game::gameLoop()
 {
-    int frameCounter = 0;
-    const int baseGravityInterval = 6; // Controls natural fall speed (lower = faster)
-
-    while (!gameOver)
+    clock.start();
+    renderThread.resetStats();
+    renderThread.start();
+    render(nullptr);
+    while (!engine.isGameOver() && !exitGame)
     {
-        processInput(); // Read and handle all player input
+        // Sleep until a key arrives, the piece is due to fall by itself (the bot acts on every tick),
+        // or the status message expires; fast autoplay does not sleep at all
+        int waitMs = autoPlayer ? (options.fast ? 0 : clock.millisecondsUntilTick(0))
+                                : clock.millisecondsUntilTick(engine.getFramesUntilGravity());
+        if (message[0] != '\0')
+        {
+            long long messageMs = std::chrono::ceil<std::chrono::milliseconds>(messageExpires - GameClock::Clock::now()).count();
+            waitMs = static_cast<int>(std::max(0LL, std::min<long long>(waitMs, messageMs)));
+        }
+        bool hasInput;
+        {
+            PROFILE_SCOPE(SLEEP);
+            hasInput = inputHandler.waitForInput(waitMs);
+        }
 
-        if (paused)
-        { // Handle paused state (skip updates/render)
-            showPauseScreen();
-            waitForUnpause();
-            continue;
+        // Run every tick that is due; if we fell behind they run back to back and only one frame is drawn
+        if (autoPlayer && options.fast)
+            runFrames(FAST_FRAMES);
+        else
+        {
+            int gravitySteps = runFrames(clock.dueTicks());
+            if (gravitySteps > 1)
+                clock.framesSkipped(gravitySteps - 1);
         }
 
-        // Apply gravity at regular intervals (depends on level)
-        if (frameCounter % std::max(1, (baseGravityInterval - level)) == 0)
+        if (hasInput && !engine.isGameOver())
         {
-            if (!board.movePiece(currentPiece, 0, 1))
-            {                         // Try moving down
-                handlePieceLanding(); // Piece lands if blocked
-                spawnPiece();         // New piece starts falling
-                if (board.isCollision(currentPiece))
-                { // Collision immediately = game over
-                    gameOver = true;
-                }
+            processInput(); // Read and handle all player input
+
+            if (paused)
+            { // Handle paused state (the clock stops while paused)
+                clock.pause();
+                showPauseScreen();
+                renderThread.stop(); // Nothing changes until the game resumes
+                waitForUnpause();
+                renderThread.start();
+                clock.resume();
             }
         }
 
-        render();     // Redraw game state
-        SLEEP_MS(20); // Control game speed (50 FPS target)
-        frameCounter++;
+        if (message[0] != '\0' && GameClock::Clock::now() >= messageExpires)
+            message[0] = '\0'; // Status message has been shown long enough
+        render(message[0] != '\0' ? message : nullptr); // Redraw game state
     }
+    renderThread.stop(); // The last frame is on screen before anything else is printed
+}
+
+// Runs up to due frames. Without the bot these are gravity ticks (keys are applied as they arrive);
+// with it, every frame is a full step with the bot's actions, and fast mode stops after each lock
+// so that every placed piece is drawn.
+int Game::runFrames(int due)
+{
+    int gravitySteps = 0;
+    for (; due > 0 && !engine.isGameOver(); --due)
+    {
+        if (engine.getFramesUntilGravity() == 0)
+            gravitySteps++; // This tick moves the piece
+        PROFILE_SCOPE(GRAVITY);
+        if (!autoPlayer)
+        {
+            handleEvents(engine.tick());
+            continue;
+        }
+
+        unsigned actions = autoPlayer->chooseActions(engine);
+        if (actions != 0)
+            replay.record(engine.getFrame(), actions);
+        Engine::StepResult result = engine.step(actions);
+        handleEvents(result);
+        if (options.fast && (result.events & Engine::PIECE_LOCKED))
+            break;
+    }
+    return gravitySteps;
 }
 
 // Process all player input (movement, rotation, pause, etc.)
 void Game::processInput()
 {
+    PROFILE_SCOPE(PROCESS_INPUT);
     inputHandler.update(); // Poll all keys
 
     if (inputHandler.quitPressed())
     { // Quit game if 'q' pressed
-        gameOver = true;
         exitGame = true;
     }
 
@@ -98,111 +155,212 @@ void Game::processInput()
         paused = !paused;
     }
 
-    if (paused)
-        return; // Skip all movement processing when paused
-
-    // Handle movement and rotation based on pressed or held keys
-    if (inputHandler.leftPressed() || inputHandler.leftHeld())
-    {
-        board.movePiece(currentPiece, -1, 0); // Move left
+    if (Profiler::ENABLED && inputHandler.overlayPressed())
+    { // Show or hide the stage timings if 'o' pressed (profiling builds only)
+        showOverlay = !showOverlay;
     }
 
-    if (inputHandler.rightPressed() || inputHandler.rightHeld())
+    if (options.checkpointFile != nullptr && !paused && !exitGame)
     {
-        board.movePiece(currentPiece, 1, 0); // Move right
+        if (inputHandler.savePressed())
+            saveCheckpoint(); // Save the game as it stands if 's' pressed
+        if (inputHandler.loadPressed())
+            loadCheckpoint(); // Continue the saved game if 'l' pressed
     }
 
-    if (inputHandler.downPressed() || inputHandler.downHeld())
-    {
-        board.movePiece(currentPiece, 0, 1); // Soft drop
-    }
+    if (paused || exitGame || autoPlayer)
+        return; // Skip all movement processing when paused (or when the bot is playing)
 
+    // Translate pressed or held keys into engine actions
+    unsigned actions = 0;
+    if (inputHandler.leftPressed() || inputHandler.leftHeld())
+        actions |= Engine::MOVE_LEFT;
+    if (inputHandler.rightPressed() || inputHandler.rightHeld())
+        actions |= Engine::MOVE_RIGHT;
+    if (inputHandler.downPressed() || inputHandler.downHeld())
+        actions |= Engine::SOFT_DROP;
     if (inputHandler.rotatePressed())
-    {
-        board.rotatePiece(currentPiece); // Rotate piece
-    }
-
+        actions |= Engine::ROTATE;
     if (inputHandler.hardDropPressed())
-    { // Hard drop (instantly falls to bottom)
-        while (board.movePiece(currentPiece, 0, 1))
-            ;
-        handlePieceLanding();
-        spawnPiece();
-    }
+        actions |= Engine::HARD_DROP;
+
+    if (actions != 0)
+        replay.record(engine.getFrame(), actions);
+    handleEvents(engine.input(actions));
 }
 
-// Clears screen and displays current score, level, and board
-void Game::render()
+// Writes the replay of the game that just ended, if recording is enabled
+void Game::saveReplay()
 {
-    system(CLEAR_SCREEN);
-    std::cout << "Score: " << score << " | Level: " << level << " | High Score: " << highScore << "\n";
-    board.draw(currentPiece); // Draw current board and falling piece
+    if (options.recordDir == nullptr || resumed)
+        return; // A replay starts from the seed, which a resumed game no longer matches
+
+    char path[512];
+    std::snprintf(path, sizeof(path), "%s/tetris-%ld.replay", options.recordDir, static_cast<long>(time(nullptr)));
+    if (!replay.finish(engine, path))
+        std::cerr << "Could not write replay " << path << "\n";
 }
 
-// Spawns a new random piece at starting position (top-center)
-void Game::spawnPiece()
+// Appends the game that just ended to the score file. A game quit before its first piece
+// landed is not counted, and neither is a resumed one: its totals include the part played before
+// the save, which the game it was saved from already counts (or will).
+void Game::saveScore()
 {
-    currentPiece = Tetromino::getRandomPiece();
-    currentPiece.setPosition(4, 0);
+    if (!scores.isOpen() || resumed || engine.getPiecesPlaced() == 0)
+        return;
+    if (!scores.append(ScoreStore::recordOf(engine, static_cast<int64_t>(time(nullptr)))))
+        std::cerr << "Could not save the score to " << options.scoreFile << "\n";
 }
 
-// Handles logic when a piece lands (scoring, clearing lines, leveling up)
-void Game::handlePieceLanding()
+// Saves the running game; the bot's games can be saved too (for --fork)
+void Game::saveCheckpoint()
 {
-    board.placePiece(currentPiece);         // Lock piece into grid
-    int lines = board.clearFullLines();     // Clear any full rows
-    linesCleared += lines;                  // Track cleared lines
-    score += lines * 100;                   // Score 100 points per line
-    increaseLevel();                        // Check for level-up
-    highScore = std::max(highScore, score); // Track high score
+    Checkpoint checkpoint;
+    engine.save(checkpoint);
+    if (checkpoint.write(options.checkpointFile))
+        std::snprintf(message, sizeof(message), "Saved to %s", options.checkpointFile);
+    else
+        std::snprintf(message, sizeof(message), "Could not save to %s", options.checkpointFile);
+    messageExpires = GameClock::Clock::now() + std::chrono::milliseconds(MESSAGE_MS);
+}
+
+// Replaces the running game with the saved one, which continues exactly where it was saved. The
+// game it replaces ends there and is scored like any other.
+void Game::loadCheckpoint()
+{
+    Checkpoint checkpoint;
+    Engine loaded;
+    if (checkpoint.read(options.checkpointFile) && loaded.restore(checkpoint))
+    {
+        saveScore();
+        engine = loaded;
+        if (autoPlayer)
+            autoPlayer->forgetPlan(); // Its plan was for the old piece
+        resumed = true;
+        highScore = std::max(highScore, engine.getScore());
+        std::snprintf(message, sizeof(message), "Resumed from %s", options.checkpointFile);
+    }
+    else
+        std::snprintf(message, sizeof(message), "No saved game in %s", options.checkpointFile);
+    messageExpires = GameClock::Clock::now() + std::chrono::milliseconds(MESSAGE_MS);
 }
 
-// Increases level after every 3 cleared lines
-void Game::increaseLevel()
+// Reacts to what happened inside the engine this frame
+void Game::handleEvents(const Engine::StepResult &result)
 {
-    if (linesCleared >= level * 3)
+    highScore = std::max(highScore, engine.getScore()); // Track high score
+
+    if (result.events & Engine::LEVEL_UP)
     {
-        level++;
-        std::cout << "Level Up! Now at Level " << level << "\n";
-        SLEEP_MS(500); // Brief pause to show message
+        // Shown by the next frames without stopping the game
+        std::snprintf(message, sizeof(message), "Level Up! Now at Level %d", engine.getLevel());
+        messageExpires = GameClock::Clock::now() + std::chrono::milliseconds(MESSAGE_MS);
     }
 }
 
+// Publishes the current score, level, and board to the render thread, which draws the newest one
+void Game::render(const char *message)
+{
+    Frame &frame = renderThread.frame();
+    engine.getBoard().copyCells(engine.getCurrentPiece(), frame.cells); // Current board and falling piece
+    frame.score = engine.getScore();
+    frame.level = engine.getLevel();
+    frame.highScore = highScore;
+    frame.nextPiece = Tetromino::typeChar(engine.getNextPiece(0)); // Served from the precomputed queue
+    frame.engineFrame = engine.getFrame();
+    std::snprintf(frame.message, sizeof(frame.message), "%s", message != nullptr ? message : "");
+    frame.overlay[0] = '\0';
+    if (Profiler::ENABLED && showOverlay)
+        Profiler::formatOverlay(frame.overlay, sizeof(frame.overlay));
+    renderThread.publish();
+
+    if (broadcast.isOpen())
+        broadcast.publish(engine); // Spectators see the same frames as the player
+}
+
 // Displays pause message
-void Game::showPauseScreen() const
+void Game::showPauseScreen()
 {
-    std::cout << "\n** Paused - Press P to Resume **\n";
+    render("** Paused - Press P to Resume **");
 }
 
-// Loops until player presses 'p' again to unpause
+// Blocks until player presses 'p' again to unpause (or 'q' to quit)
 void Game::waitForUnpause()
 {
-    while (true)
+    while (!exitGame)
     {
+        inputHandler.waitForInput(-1); // Sleep until a key arrives
         inputHandler.update();
-        if (inputHandler.pausePressed())
+        if (inputHandler.quitPressed())
+        {
+            exitGame = true;
+        }
+        else if (inputHandler.pausePressed())
         {
             paused = false;
             break;
         }
-        SLEEP_MS(50); // Short delay to avoid busy loop
     }
 }
 
 // Displays game over message with final score and high score
-void Game::showGameOverScreen() const
+void Game::showGameOverScreen()
 {
-    std::cout << "\nGame Over! Final Score: " << score << "\n";
+    renderer.finish(); // Continue below the last frame
+    std::cout << "\nGame Over! Final Score: " << engine.getScore() << "\n";
     std::cout << "High Score: " << highScore << "\n";
+    if (scores.isOpen())
+    {
+        const ScoreStore::Summary &lifetime = scores.getSummary();
+        std::cout << "Lifetime: " << lifetime.games << " games, " << lifetime.totalLines << " lines, mean score "
+                  << static_cast<long long>(lifetime.meanScore() + 0.5) << "\n";
+    }
+    if (renderer.getFrameCount() > 0)
+    {
+        std::cout << "Rendered " << renderer.getFrameCount() << " frames, "
+                  << renderer.getTotalBytes() / renderer.getFrameCount() << " bytes per frame on average\n";
+    }
+
+    if (broadcast.isOpen())
+    {
+        const BroadcastWriter::Stats &sent = broadcast.getStats();
+        std::cout << "Broadcast " << sent.messages << " deltas (" << sent.keyframes << " keyframes), "
+                  << (sent.messages > 0 ? sent.bytes / sent.messages : 0) << " bytes each on average\n";
+    }
+
+    // Timing report: how closely the ticks kept to their schedule and how often frames were drawn
+    const GameClock::IntervalStats &lateness = clock.getTickLateness();
+    const RenderThread::Stats &display = renderThread.getStats();
+    std::printf("Wake-ups: %ld, late by %.2f ms on average (%.2f ms max); %ld frames skipped, %ld ticks dropped\n",
+                lateness.count, lateness.meanMs(), lateness.maxMs, clock.getSkippedFrames(), clock.getDroppedTicks());
+    std::printf("Frames: every %.2f ms on average (%.2f-%.2f ms), rendering took %.3f ms on average (%.3f ms max)\n",
+                display.frameIntervals.meanMs(), display.frameIntervals.minMs, display.frameIntervals.maxMs,
+                display.renderTimes.meanMs(), display.renderTimes.maxMs);
+    std::printf("Render thread: %ld of %ld snapshots drawn, %ld dropped (%.1f%%); %ld engine frames never rendered\n",
+                display.drawn, display.published, display.dropped, 100.0 * display.dropRate(), display.unrenderedFrames);
+    if (autoPlayer)
+    {
+        const AutoPlayer::Stats &search = autoPlayer->getStats();
+        std::printf("Autoplayer: beam %d, depth %d on %u threads; %ld decisions, %.3f ms on average (%.3f ms max), %.0f nodes/s, %ld replans\n",
+                    autoPlayer->getSettings().beamWidth, autoPlayer->getSettings().depth, pool->size(), search.decisions,
+                    search.meanDecisionMs(), search.maxDecisionMs, search.nodesPerSecond(), search.replans);
+    }
+    std::fflush(stdout);
 }
 
 // Asks player if they want to restart or quit
 bool Game::promptRestart()
 {
-    std::cout << "Press R to Restart or Q to Quit: ";
-    char choice;
-    std::cin >> choice;
-    if (choice == 'Q' || choice == 'q')
+    std::cout << "Press R to Restart or Q to Quit: " << std::flush;
+    while (true)
+    {
+        inputHandler.waitForInput(-1); // The terminal stays in raw mode, so a single key answers
+        inputHandler.update();
+        if (inputHandler.restartPressed() || inputHandler.quitPressed())
+            break;
+    }
+    std::cout << "\n";
+    if (inputHandler.quitPressed())
         exitGame = true;
-    return choice == 'R' || choice == 'r';
+    return !exitGame;
 }
@@ -1,47 +1,87 @@
 #ifndef GAME_H
 #define GAME_H
 
-#include "Board.h"
-#include "Tetromino.h"
+#include "AutoPlayer.h"
+#include "Broadcast.h"
+#include "Engine.h"
+#include "GameClock.h"
 #include "InputHandler.h"
+#include "RenderThread.h"
+#include "Renderer.h"
+#include "Replay.h"
+#include "ScoreStore.h"
+#include "ThreadPool.h"
 #include <iostream>
 #include <chrono>
+#include <memory>
 
-// The Game class controls the entire game flow
+// Settings of an interactive session
+struct GameOptions
+{
+    Randomizer::Mode randomizer = Randomizer::UNIFORM; // Piece randomizer
+    const char *recordDir = nullptr;                   // Directory to save a replay of every game (nullptr = off)
+    bool autoplay = false;                             // Let the beam-search bot play instead of the keyboard
+    bool fast = false;                                 // With autoplay: run frames flat out and draw once per piece
+    AutoPlayer::Settings autoPlayer;                   // Bot search settings
+    unsigned threads = 0;                              // Threads the bot expands on (0 = all cores)
+    const char *broadcast = nullptr;                   // Shared-memory name to publish frames under (nullptr = off)
+    const char *scoreFile = nullptr;                   // Lifetime high score and statistics (nullptr = session only)
+    const char *checkpointFile = nullptr;              // Where S saves and L resumes the game (nullptr = keys disabled)
+};
+
+// The Game class is the interactive front end: it feeds keyboard input to the Engine and draws the result
 class Game
 {
 public:
-    Game();     // Constructor
-    void run(); // Main function to start and manage the game
+    explicit Game(const GameOptions &options); // Constructor
+    void run();                                // Main function to start and manage the game
 
 private:
-    Board board;               // The game board
-    Tetromino currentPiece;    // The currently falling piece
+    static const int FRAME_MS = 20;     // Length of one engine frame (50 frames per second)
+    static const int MESSAGE_MS = 1000; // How long a status message such as "Level Up!" stays on screen
+    static const int FAST_FRAMES = 1000; // Frame limit per drawn frame in fast autoplay (one piece normally locks well before)
+
+    Engine engine;             // Game rules and state (board, piece, score, level)
     InputHandler inputHandler; // Handles player input
+    Renderer renderer;         // Draws frames to the terminal
+    RenderThread renderThread; // Draws them off the simulation thread (owns renderer while running)
+    ReplayWriter replay;       // Records the inputs of the current game
+    GameOptions options;       // Session settings
+    GameClock clock;           // Fixed-timestep pacing and tick timing statistics
+    BroadcastWriter broadcast; // Frames published for spectators (when options.broadcast is set)
+    ScoreStore scores;         // Lifetime high score and statistics (when options.scoreFile is set)
 
-    int score;        // Player's score
-    int level;        // Current game level
-    int linesCleared; // Total lines cleared so far
-    int highScore;    // Highest score achieved in current session
+    std::unique_ptr<ThreadPool> pool;       // Search threads of the bot (autoplay only)
+    std::unique_ptr<AutoPlayer> autoPlayer; // Bot that chooses the actions (nullptr = keyboard)
+
+    int highScore; // Highest score achieved in this session or, with a score file, ever
 
-    bool gameOver; // Flag for game-over state
     bool paused;   // Flag for pause state
     bool exitGame; // Flag to exit the game entirely
+    bool resumed;  // The game was loaded from a checkpoint, so no replay from its seed exists
+
+    bool showOverlay; // Draw the profiler's stage timings next to the board
+
+    char message[64];                            // Status line currently shown ('\0' = none)
+    GameClock::Clock::time_point messageExpires; // When the status line is cleared
 
     // Core game functions
-    void initialize();         // Initialize/reset game state
-    void gameLoop();           // Main game loop
-    void processInput();       // Handle player input
-    void render();             // Draw the game to the screen
-    void spawnPiece();         // Spawn a new tetromino
-    void handlePieceLanding(); // Handle logic when piece lands
-    void increaseLevel();      // Level progression logic
+    void initialize();                                   // Initialize/reset game state
+    void gameLoop();                                     // Main game loop
+    void processInput();                                 // Handle player input
+    int runFrames(int due);                              // Runs due frames (ticks, or bot steps); returns how many moved the piece down
+    void handleEvents(const Engine::StepResult &result); // React to engine events (level-up, scoring)
+    void render(const char *message);                    // Publish a frame of the game with an optional status line
+    void saveReplay();                                   // Write the replay of the finished game
+    void saveScore();                                    // Add the finished game to the score file
+    void saveCheckpoint();                               // Write the running game to options.checkpointFile
+    void loadCheckpoint();                               // Continue the game saved in options.checkpointFile
 
     // Utility display functions
-    void showPauseScreen() const;    // Display pause message
-    void waitForUnpause();           // Wait until player unpauses
-    void showGameOverScreen() const; // Display game-over message
-    bool promptRestart();            // Ask player if they want to restart
+    void showPauseScreen();    // Display pause message
+    void waitForUnpause();     // Wait until player unpauses
+    void showGameOverScreen(); // Display game-over message
+    bool promptRestart();      // Ask player if they want to restart
 };
 
 #endif
@@ -0,0 +1,100 @@
+#include "GameClock.h"
+
+namespace
+{
+    // Converts a steady_clock duration to fractional milliseconds
+    double toMs(GameClock::Clock::duration d)
+    {
+        return std::chrono::duration<double, std::milli>(d).count();
+    }
+}
+
+// Adds one interval to the running statistics
+void GameClock::IntervalStats::add(double ms)
+{
+    if (count == 0 || ms < minMs)
+        minMs = ms;
+    if (count == 0 || ms > maxMs)
+        maxMs = ms;
+    totalMs += ms;
+    count++;
+}
+
+// Constructor - sets the tick length
+GameClock::GameClock(int tickMs)
+    : period(std::chrono::milliseconds(tickMs)), accumulator(0), paused(false), skippedFrames(0), droppedTicks(0) {}
+
+// Starts a new game: tick 0 is due immediately
+void GameClock::start()
+{
+    last = Clock::now();
+    accumulator = period;
+    paused = false;
+    tickLateness = IntervalStats();
+    skippedFrames = 0;
+    droppedTicks = 0;
+}
+
+// Folds the time elapsed so far into the accumulator and stops counting
+void GameClock::pause()
+{
+    if (paused)
+        return;
+    Clock::time_point now = Clock::now();
+    accumulator += now - last;
+    last = now;
+    paused = true;
+}
+
+// Restarts counting from now
+void GameClock::resume()
+{
+    if (!paused)
+        return;
+    last = Clock::now();
+    paused = false;
+}
+
+// Converts the accumulated time into whole ticks and records how late the newest one is
+int GameClock::dueTicks()
+{
+    if (paused)
+        return 0;
+
+    Clock::time_point now = Clock::now();
+    accumulator += now - last;
+    last = now;
+
+    long ticks = static_cast<long>(accumulator / period);
+    if (ticks > MAX_CATCH_UP_TICKS)
+    { // A stall this long (debugger, suspended process) is skipped rather than replayed
+        droppedTicks += ticks - MAX_CATCH_UP_TICKS;
+        accumulator -= (ticks - MAX_CATCH_UP_TICKS) * period;
+        ticks = MAX_CATCH_UP_TICKS;
+    }
+    accumulator -= ticks * period;
+
+    // Only the newest tick measures how late the loop woke up; older ones in the batch were
+    // either idle frames it chose to sleep through or frames it could not keep up with
+    if (ticks > 0)
+        tickLateness.add(toMs(accumulator));
+    return static_cast<int>(ticks);
+}
+
+// Milliseconds (rounded up, at least 0) before tick number ticksAhead is due
+int GameClock::millisecondsUntilTick(int ticksAhead) const
+{
+    if (paused)
+        return -1;
+    Clock::duration elapsed = accumulator + (Clock::now() - last);
+    Clock::duration remaining = (ticksAhead + 1) * period - elapsed;
+    if (remaining <= Clock::duration::zero())
+        return 0;
+    return static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(remaining).count());
+}
+
+// Counts state changes that were simulated without being drawn
+void GameClock::framesSkipped(int count)
+{
+    skippedFrames += count;
+}
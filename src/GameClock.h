@@ -0,0 +1,53 @@
+#ifndef GAME_CLOCK_H
+#define GAME_CLOCK_H
+
+#include <chrono>
+
+// GameClock paces the simulation with a fixed timestep. Elapsed steady_clock time is added to an
+// accumulator and converted into whole ticks, so the tick rate stays exact however long rendering
+// takes; when the loop falls behind it runs the missed ticks back to back and publishes one frame.
+class GameClock
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    // Running statistics for a series of time intervals, in milliseconds
+    struct IntervalStats
+    {
+        long count = 0;
+        double totalMs = 0;
+        double minMs = 0;
+        double maxMs = 0;
+
+        void add(double ms);
+        double meanMs() const { return count > 0 ? totalMs / count : 0; }
+    };
+
+    static const int MAX_CATCH_UP_TICKS = 50; // Ticks run at most per update; longer stalls are dropped
+
+    explicit GameClock(int tickMs); // Constructor - sets the tick length
+
+    void start();  // Starts a new game at tick 0 and clears the statistics
+    void pause();  // Stops the clock (time spent paused is not simulated)
+    void resume(); // Continues after pause()
+
+    int dueTicks();                                  // Ticks that are due now; each is counted as run
+    int millisecondsUntilTick(int ticksAhead) const; // Time until tick number ticksAhead (0 = next tick) is due
+    void framesSkipped(int count);                   // Records visible updates that were never drawn
+
+    const IntervalStats &getTickLateness() const { return tickLateness; } // How long after its slot the awaited tick ran
+    long getSkippedFrames() const { return skippedFrames; }               // Visible updates simulated but never drawn
+    long getDroppedTicks() const { return droppedTicks; }                 // Ticks discarded after a stall
+
+private:
+    Clock::duration period;      // Length of one tick
+    Clock::duration accumulator; // Elapsed time not yet turned into ticks
+    Clock::time_point last;      // When the accumulator was last updated
+    bool paused;                 // Whether the clock is stopped
+
+    IntervalStats tickLateness; // Statistics reported by the getters above
+    long skippedFrames;
+    long droppedTicks;
+};
+
+#endif
@@ -0,0 +1,387 @@
+#include "GameServer.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#ifdef __linux__
+#include <cerrno>
+#include <csignal>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // epoll tokens of the two non-session descriptors (sessions use their address)
+    const uint64_t LISTEN_TOKEN = 0;
+    const uint64_t TIMER_TOKEN = 1;
+
+    const int MAX_EVENTS = 256; // Events handled per epoll_wait
+    const int MAX_CATCH_UP = 5; // Ticks run at most per timer expiration; longer stalls are dropped
+
+    volatile sig_atomic_t stopRequested = 0;
+
+    void requestStop(int)
+    {
+        stopRequested = 1;
+    }
+}
+
+// Constructor - allocates every session and the active list up front
+GameServer::GameServer(const Settings &settings)
+    : settings(settings), pool(settings.maxSessions), nextSeed(settings.seed), epollFd(-1), listenFd(-1), timerFd(-1)
+{
+    active.reserve(settings.maxSessions);
+    closed.reserve(settings.maxSessions);
+}
+
+// Destructor - closes every client and descriptor still open
+GameServer::~GameServer()
+{
+    closeAll();
+}
+
+// Sessions, inputs, deltas and tick cost since run() started
+void GameServer::printSummary(std::ostream &out) const
+{
+    double meanTickUs = stats.ticks > 0 ? stats.tickSeconds * 1e6 / stats.ticks : 0;
+    out << "Sessions served: " << stats.sessionsServed << " (peak " << stats.peakSessions << " at once, "
+        << stats.refused << " refused)\n"
+        << "Inputs applied:  " << stats.inputs << "\n"
+        << "Deltas sent:     " << stats.deltas << " (" << stats.bytesSent << " bytes)\n"
+        << "Ticks:           " << stats.ticks << " (" << stats.lateTicks << " late, " << meanTickUs
+        << " us mean for all sessions)\n";
+}
+
+#ifdef __linux__
+
+// Listens on path and runs the event loop: accepts, inputs, writable sockets and the gravity timer
+bool GameServer::run(const char *path)
+{
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (std::strlen(path) >= sizeof(address.sun_path))
+    {
+        std::cerr << "Socket path too long: " << path << "\n";
+        return false;
+    }
+    std::strcpy(address.sun_path, path);
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    unlink(path); // A socket left behind by an earlier run
+    if (listenFd < 0 || bind(listenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+        listen(listenFd, SOMAXCONN) != 0)
+    {
+        std::cerr << "Cannot listen on " << path << ": " << std::strerror(errno) << "\n";
+        closeAll();
+        return false;
+    }
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    itimerspec interval = {};
+    interval.it_interval.tv_nsec = TICK_MS * 1000000L;
+    interval.it_value = interval.it_interval;
+    epoll_event listenEvent = {};
+    listenEvent.events = EPOLLIN;
+    listenEvent.data.u64 = LISTEN_TOKEN;
+    epoll_event timerEvent = {};
+    timerEvent.events = EPOLLIN;
+    timerEvent.data.u64 = TIMER_TOKEN;
+    if (epollFd < 0 || timerFd < 0 || timerfd_settime(timerFd, 0, &interval, nullptr) != 0 ||
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &listenEvent) != 0 ||
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, timerFd, &timerEvent) != 0)
+    {
+        std::cerr << "Cannot set up the event loop: " << std::strerror(errno) << "\n";
+        closeAll();
+        unlink(path);
+        return false;
+    }
+
+    // No SA_RESTART, so a signal wakes epoll_wait with EINTR and the loop sees the request
+    struct sigaction stop = {};
+    stop.sa_handler = requestStop;
+    sigaction(SIGINT, &stop, nullptr);
+    sigaction(SIGTERM, &stop, nullptr);
+    stopRequested = 0;
+
+    std::cout << "Serving up to " << settings.maxSessions << " games on " << path << " (Ctrl+C to stop)\n";
+    epoll_event events[MAX_EVENTS];
+    while (!stopRequested)
+    {
+        int count = epoll_wait(epollFd, events, MAX_EVENTS, -1);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            std::cerr << "epoll_wait: " << std::strerror(errno) << "\n";
+            break;
+        }
+        for (int i = 0; i < count; ++i)
+        {
+            uint64_t token = events[i].data.u64;
+            if (token == LISTEN_TOKEN)
+            {
+                acceptClients();
+                continue;
+            }
+            if (token == TIMER_TOKEN)
+            {
+                uint64_t expirations = 0;
+                if (read(timerFd, &expirations, sizeof(expirations)) == sizeof(expirations))
+                {
+                    stats.lateTicks += static_cast<long>(expirations - 1);
+                    for (uint64_t tick = 0; tick < expirations && tick < MAX_CATCH_UP; ++tick)
+                        runTick();
+                }
+                continue;
+            }
+
+            Session &session = *reinterpret_cast<Session *>(token);
+            if (session.fd < 0)
+                continue; // Closed earlier in this batch
+            if (events[i].events & (EPOLLERR | EPOLLHUP))
+            {
+                closeSession(session);
+                continue;
+            }
+            if ((events[i].events & EPOLLOUT) && flush(session) && session.outUsed == 0)
+            {
+                watchOutput(session, false);
+                if (session.dirty)
+                    sendUpdate(session, false);
+            }
+            if (session.fd >= 0 && (events[i].events & (EPOLLIN | EPOLLRDHUP)))
+                readInputs(session);
+        }
+        releaseClosed();
+    }
+
+    closeAll();
+    unlink(path);
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+    return true;
+}
+
+// Every new client gets a pooled session and a keyframe of its fresh game
+void GameServer::acceptClients()
+{
+    while (true)
+    {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+            return; // EAGAIN: no more pending connections (other errors only affect that client)
+
+        Session *session = pool.acquire();
+        if (session == nullptr)
+        {
+            close(fd);
+            stats.refused++;
+            continue;
+        }
+
+        session->engine = Engine(nextSeed++, settings.randomizer); // Plain copy, no allocation
+        Protocol::clear(session->sent);
+        session->fd = fd;
+        session->ack = session->ackSent = 0;
+        session->dirty = false;
+        session->inUsed = session->outUsed = session->outSent = 0;
+
+        epoll_event event = {};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.u64 = reinterpret_cast<uint64_t>(session);
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0)
+        {
+            close(fd);
+            session->fd = -1;
+            pool.release(session);
+            continue;
+        }
+        session->slot = static_cast<int>(active.size());
+        active.push_back(session);
+        stats.sessionsServed++;
+        if (static_cast<int>(active.size()) > stats.peakSessions)
+            stats.peakSessions = static_cast<int>(active.size());
+
+        sendUpdate(*session, true);
+    }
+}
+
+// Reads everything available, applies each complete message in order, then answers once
+void GameServer::readInputs(Session &session)
+{
+    uint8_t buffer[1024];
+    bool applied = false;
+    while (true)
+    {
+        ssize_t got = read(session.fd, buffer, sizeof(buffer));
+        if (got < 0 && errno == EINTR)
+            continue;
+        if (got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break; // Everything read
+        if (got <= 0)
+        {
+            closeSession(session); // Client disconnected
+            return;
+        }
+
+        for (ssize_t i = 0; i < got; ++i)
+        {
+            session.inBuffer[session.inUsed++] = buffer[i];
+            if (session.inUsed < Protocol::INPUT_SIZE)
+                continue;
+            session.inUsed = 0;
+
+            uint16_t sequence;
+            std::memcpy(&sequence, session.inBuffer + 2, sizeof(sequence));
+            if (session.inBuffer[0] == Protocol::INPUT)
+                session.engine.input(session.inBuffer[1]);
+            else if (session.inBuffer[0] == Protocol::RESTART)
+                session.engine.reset(nextSeed++);
+            else
+            {
+                closeSession(session); // Not a client of this protocol
+                return;
+            }
+            session.ack = sequence;
+            stats.inputs++;
+            applied = true;
+        }
+    }
+    if (applied)
+        sendUpdate(session, false);
+}
+
+// One gravity frame for every open game, each answered with a delta if it changed
+void GameServer::runTick()
+{
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < active.size(); ++i)
+    {
+        Session &session = *active[i];
+        if (session.engine.isGameOver())
+            continue; // Waiting for the client to restart
+        session.engine.tick();
+        sendUpdate(session, false);
+        if (active.size() > i && active[i] != &session)
+            --i; // The session was closed and the last one moved into its slot
+    }
+    stats.ticks++;
+    stats.tickSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Deltas are always taken against the sent screen, so a delta held back while the socket is full
+// is replaced by one that covers everything since. Inputs are always answered (even with no
+// change) so the client sees its acknowledgement; ticks only send when something changed.
+void GameServer::sendUpdate(Session &session, bool keyframe)
+{
+    if (session.outUsed > 0)
+    {
+        session.dirty = true;
+        return;
+    }
+    Protocol::Screen screen;
+    Protocol::capture(session.engine, screen);
+    bool changed = !Protocol::same(screen, session.sent);
+    if (!changed && !keyframe && session.ack == session.ackSent)
+        return;
+
+    session.outUsed = Protocol::encodeDelta(session.sent, screen, session.ack, keyframe, session.outBuffer);
+    session.outSent = 0;
+    session.dirty = false;
+    session.sent = screen;
+    session.ackSent = session.ack;
+    stats.deltas++;
+    if (flush(session) && session.outUsed > 0)
+        watchOutput(session, true);
+}
+
+// Writes as much of the queued delta as the socket takes; closes the session if the client is gone
+bool GameServer::flush(Session &session)
+{
+    while (session.outSent < session.outUsed)
+    {
+        ssize_t written = send(session.fd, session.outBuffer + session.outSent, session.outUsed - session.outSent,
+                               MSG_NOSIGNAL);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return true; // Rest goes out when epoll reports the socket writable
+            closeSession(session);
+            return false;
+        }
+        session.outSent += static_cast<size_t>(written);
+        stats.bytesSent += written;
+    }
+    session.outUsed = session.outSent = 0;
+    return true;
+}
+
+// Turns EPOLLOUT on while a delta is partly unsent, and off once it has gone out
+void GameServer::watchOutput(Session &session, bool enable)
+{
+    epoll_event event = {};
+    event.events = EPOLLIN | EPOLLRDHUP;
+    if (enable)
+        event.events |= EPOLLOUT;
+    event.data.u64 = reinterpret_cast<uint64_t>(&session);
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, session.fd, &event);
+}
+
+// Closing the descriptor also removes it from the epoll set. The session goes back to the pool only
+// after the current batch of events: a client accepted later in the batch would otherwise get it,
+// and a stale event of the old descriptor still in the batch would close the new client.
+void GameServer::closeSession(Session &session)
+{
+    close(session.fd);
+    session.fd = -1;
+    Session *last = active.back();
+    active[session.slot] = last;
+    last->slot = session.slot;
+    active.pop_back();
+    closed.push_back(&session);
+}
+
+// Returns the sessions closed during this batch of events to the pool
+void GameServer::releaseClosed()
+{
+    for (Session *session : closed)
+        pool.release(session);
+    closed.clear();
+}
+
+// Closes every session, then the timer, epoll and listening descriptors
+void GameServer::closeAll()
+{
+    while (!active.empty())
+        closeSession(*active.back());
+    releaseClosed();
+    for (int *fd : {&timerFd, &epollFd, &listenFd})
+    {
+        if (*fd >= 0)
+            close(*fd);
+        *fd = -1;
+    }
+}
+
+#else
+
+// Reports that the server is unavailable (epoll and timerfd are Linux only)
+bool GameServer::run(const char *)
+{
+    std::cerr << "The game server needs Linux (epoll and timerfd)\n";
+    return false;
+}
+
+// Nothing is ever opened without Linux
+void GameServer::closeAll()
+{
+}
+
+#endif
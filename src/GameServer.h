@@ -0,0 +1,97 @@
+#ifndef GAME_SERVER_H
+#define GAME_SERVER_H
+
+#include "Engine.h"
+#include "ObjectPool.h"
+#include "Protocol.h"
+#include <ostream>
+#include <vector>
+
+// GameServer hosts many independent games in one process, one per client connected to a local Unix
+// domain socket. A single epoll loop accepts clients, reads their inputs and runs every game's
+// gravity from one 50 Hz timerfd. Each input is applied at once and answered with a Protocol delta
+// (the cells that changed plus score, level and next piece), so a client's latency is one round
+// trip and never waits for a tick.
+//
+// Sessions come from an ObjectPool sized at startup, so accepting a client does not allocate.
+// A client that stops reading never gets a queue: while an earlier delta is still unsent, changes
+// are folded into the next one, computed against what the client has actually been sent.
+//
+// Linux only (epoll and timerfd); elsewhere run() reports that the server is unavailable.
+class GameServer
+{
+public:
+    struct Settings
+    {
+        int maxSessions = 1024;                            // Games that can run at once (more clients are refused)
+        unsigned seed = 1;                                 // Seed of the first session; each new one uses the next
+        Randomizer::Mode randomizer = Randomizer::UNIFORM; // Piece randomizer of every game
+    };
+
+    struct Stats
+    {
+        long sessionsServed = 0; // Clients accepted
+        int peakSessions = 0;    // Most sessions open at once
+        long refused = 0;        // Clients closed because the pool was full
+        long inputs = 0;         // Input and restart messages applied
+        long deltas = 0;         // Deltas sent (keyframes included)
+        long long bytesSent = 0; // Delta bytes written to clients
+        long ticks = 0;          // Gravity ticks run
+        long lateTicks = 0;      // Timer expirations that found the previous tick still unprocessed
+        double tickSeconds = 0;  // Time spent running ticks
+    };
+
+    static const int TICK_MS = 20; // One gravity frame for every session (50 per second, as in Game)
+
+    explicit GameServer(const Settings &settings); // Constructor - allocates every session up front
+    ~GameServer();
+
+    GameServer(const GameServer &) = delete;
+    GameServer &operator=(const GameServer &) = delete;
+
+    // Serves clients on the socket at path until SIGINT or SIGTERM; false if it cannot be set up
+    bool run(const char *path);
+
+    const Stats &getStats() const { return stats; }
+    void printSummary(std::ostream &out) const;
+
+private:
+    // One connected client and its game
+    struct Session
+    {
+        Engine engine;
+        Protocol::Screen sent; // What the client has been told so far
+        int fd = -1;
+        int slot = 0;          // Index in active
+        uint16_t ack = 0;      // Sequence of the last input applied
+        uint16_t ackSent = 0;  // ... as carried by the last delta
+        bool dirty = false;    // Changed while a delta was still unsent
+        size_t inUsed = 0;     // Bytes of a partial input message in inBuffer
+        size_t outUsed = 0;    // Bytes of the unsent delta in outBuffer
+        size_t outSent = 0;    // ... of which have been written
+        uint8_t inBuffer[Protocol::INPUT_SIZE];
+        uint8_t outBuffer[Protocol::MAX_DELTA];
+    };
+
+    Settings settings;
+    ObjectPool<Session> pool;      // Every session, allocated once
+    std::vector<Session *> active; // Open sessions (reserved up front; order changes on removal)
+    std::vector<Session *> closed; // Closed in the current batch of events, not yet back in the pool
+    Stats stats;
+    unsigned nextSeed;             // Seed of the next game started
+    int epollFd;
+    int listenFd;
+    int timerFd;
+
+    void acceptClients();                             // Accepts every pending connection
+    void readInputs(Session &session);                // Applies complete input messages and answers them
+    void runTick();                                   // One gravity frame for every session
+    void sendUpdate(Session &session, bool keyframe); // Queues and writes a delta if anything changed
+    bool flush(Session &session);                     // Writes queued bytes; false if the client is gone
+    void watchOutput(Session &session, bool enable);  // Whether epoll reports the socket as writable
+    void closeSession(Session &session);
+    void releaseClosed(); // Returns the sessions closed in this batch to the pool
+    void closeAll();
+};
+
+#endif
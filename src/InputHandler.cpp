@@ -1,10 +1,45 @@
 #include "InputHandler.h"
+#include "Profiler.h"
 #include <iostream>
 #ifdef _WIN32
 #include <conio.h>
+#else
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <poll.h>
 #endif
 
-// Constructor - initialize all keys as unpressed
+#ifndef _WIN32
+namespace
+{
+    struct termios savedTerminal;          // Terminal settings to restore on exit
+    volatile sig_atomic_t terminalRaw = 0; // Whether raw mode is currently active
+
+    // Puts the terminal back the way we found it (async-signal-safe)
+    void restoreTerminal()
+    {
+        if (terminalRaw)
+        {
+            tcsetattr(STDIN_FILENO, TCSANOW, &savedTerminal);
+            terminalRaw = 0;
+            static const char showCursor[] = "\033[0m\033[?25h";
+            ssize_t ignored = write(STDOUT_FILENO, showCursor, sizeof(showCursor) - 1);
+            (void)ignored;
+        }
+    }
+
+    // Restores the terminal, then lets the signal take its default action
+    void onTerminatingSignal(int signalNumber)
+    {
+        restoreTerminal();
+        signal(signalNumber, SIG_DFL);
+        raise(signalNumber);
+    }
+}
+#endif
+
+// Constructor - initialize all keys as unpressed and switch the terminal to raw mode once
 InputHandler::InputHandler()
 {
     for (int i = 0; i < TOTAL_KEYS; ++i)
@@ -12,11 +47,59 @@ InputHandler::InputHandler()
         keys[i] = false;
         prevKeys[i] = false;
     }
+
+#ifndef _WIN32
+    pendingLength = 0;
+    endOfInput = false;
+
+    if (!terminalRaw && tcgetattr(STDIN_FILENO, &savedTerminal) == 0)
+    {
+        struct termios raw = savedTerminal;
+        raw.c_lflag &= ~(ICANON | ECHO); // Keys arrive immediately and are not echoed (Ctrl-C still works)
+        raw.c_cc[VMIN] = 0;              // read() returns whatever is available
+        raw.c_cc[VTIME] = 0;
+        if (tcsetattr(STDIN_FILENO, TCSANOW, &raw) == 0)
+        {
+            terminalRaw = 1;
+            std::atexit(restoreTerminal);
+            signal(SIGINT, onTerminatingSignal);
+            signal(SIGTERM, onTerminatingSignal);
+            signal(SIGHUP, onTerminatingSignal);
+            signal(SIGQUIT, onTerminatingSignal);
+        }
+    }
+#endif
+}
+
+// Destructor - leave the terminal in its original mode
+InputHandler::~InputHandler()
+{
+#ifndef _WIN32
+    restoreTerminal();
+#endif
+}
+
+// Sleeps until input is available or the timeout expires; returns true if input is waiting
+bool InputHandler::waitForInput(int timeoutMs)
+{
+#ifdef _WIN32
+    if (_kbhit())
+        return true;
+    WaitForSingleObject(GetStdHandle(STD_INPUT_HANDLE), timeoutMs < 0 ? INFINITE : static_cast<DWORD>(timeoutMs));
+    return _kbhit() != 0;
+#else
+    if (endOfInput)
+        return true; // Nothing will ever arrive; report the pending quit right away
+    struct pollfd input = {STDIN_FILENO, POLLIN, 0};
+    return poll(&input, 1, timeoutMs) > 0;
+#endif
 }
 
 // Update input state - reads keys and tracks both press and hold
 void InputHandler::update()
 {
+    PROFILE_SCOPE(INPUT);
+
     // Reset all keys for this frame
     for (int i = 0; i < TOTAL_KEYS; ++i)
     {
@@ -64,19 +147,73 @@ void InputHandler::update()
             case 'Q':
                 keys[QUIT] = true;
                 break; // Quit game
+            case 'r':
+            case 'R':
+                keys[RESTART] = true;
+                break; // Restart game
+            case 'o':
+            case 'O':
+                keys[OVERLAY] = true;
+                break; // Profiler overlay
+            case 's':
+            case 'S':
+                keys[SAVE] = true;
+                break; // Save a checkpoint
+            case 'l':
+            case 'L':
+                keys[LOAD] = true;
+                break; // Resume from the checkpoint
             }
         }
     }
 #else
-    while (kbhit())
+    // Terminals report key presses (auto-repeat included) but never releases,
+    // so every byte read is a fresh press
+    for (int i = 0; i < TOTAL_KEYS; ++i)
+        prevKeys[i] = false;
+
+    if (endOfInput)
     {
-        int ch = getch(); // Get the key input
+        keys[QUIT] = true;
+        return;
+    }
 
+    // Drain everything that is pending with a single read()
+    char buffer[256];
+    std::memcpy(buffer, pending, pendingLength);
+    ssize_t count = read(STDIN_FILENO, buffer + pendingLength, sizeof(buffer) - pendingLength);
+    if (count == 0 && !terminalRaw)
+    {
+        endOfInput = true; // stdin is a closed pipe or file
+        keys[QUIT] = true;
+        return;
+    }
+    int length = pendingLength + static_cast<int>(count > 0 ? count : 0);
+    pendingLength = 0;
+    parse(buffer, length, count > 0); // Nothing new: a held-back sequence is not going to complete
+#endif
+}
+
+#ifndef _WIN32
+// Decodes plain keys and arrow-key escape sequences (ESC [ x or ESC O x). A lone ESC is ignored
+// and the bytes after it are read as keys.
+void InputHandler::parse(const char *bytes, int length, bool canWait)
+{
+    for (int i = 0; i < length; ++i)
+    {
+        char ch = bytes[i];
         if (ch == 27) // Escape sequence (for arrow keys)
         {
-            if (getch() == 91) // '[' part of escape sequence
+            bool introducer = i + 1 < length && (bytes[i + 1] == '[' || bytes[i + 1] == 'O');
+            if (canWait && (i + 1 == length || (introducer && i + 2 == length)))
+            { // Sequence may continue in the next read
+                pendingLength = length - i;
+                std::memcpy(pending, bytes + i, pendingLength);
+                return;
+            }
+            if (introducer && i + 2 < length)
             {
-                switch (getch())
+                switch (bytes[i + 2])
                 {
                 case 'A':
                     keys[ROTATE] = true;
@@ -91,28 +228,44 @@ void InputHandler::update()
                     keys[LEFT] = true;
                     break; // Left Arrow
                 }
+                i += 2;
             }
+            continue;
         }
-        else
+
+        switch (ch)
         {
-            switch (ch)
-            {
-            case ' ':
-                keys[HARD_DROP] = true;
-                break;
-            case 'p':
-            case 'P':
-                keys[PAUSE] = true;
-                break;
-            case 'q':
-            case 'Q':
-                keys[QUIT] = true;
-                break;
-            }
+        case ' ':
+            keys[HARD_DROP] = true;
+            break;
+        case 'p':
+        case 'P':
+            keys[PAUSE] = true;
+            break;
+        case 'q':
+        case 'Q':
+            keys[QUIT] = true;
+            break;
+        case 'r':
+        case 'R':
+            keys[RESTART] = true;
+            break;
+        case 'o':
+        case 'O':
+            keys[OVERLAY] = true;
+            break;
+        case 's':
+        case 'S':
+            keys[SAVE] = true;
+            break;
+        case 'l':
+        case 'L':
+            keys[LOAD] = true;
+            break;
         }
     }
-#endif
 }
+#endif
 
 // Key press functions - return true only on the initial press
 bool InputHandler::leftPressed() const { return keys[LEFT] && !prevKeys[LEFT]; }
@@ -122,37 +275,12 @@ bool InputHandler::rotatePressed() const { return keys[ROTATE] && !prevKeys[ROTA
 bool InputHandler::hardDropPressed() const { return keys[HARD_DROP] && !prevKeys[HARD_DROP]; }
 bool InputHandler::pausePressed() const { return keys[PAUSE] && !prevKeys[PAUSE]; }
 bool InputHandler::quitPressed() const { return keys[QUIT] && !prevKeys[QUIT]; }
+bool InputHandler::restartPressed() const { return keys[RESTART] && !prevKeys[RESTART]; }
+bool InputHandler::overlayPressed() const { return keys[OVERLAY] && !prevKeys[OVERLAY]; }
+bool InputHandler::savePressed() const { return keys[SAVE] && !prevKeys[SAVE]; }
+bool InputHandler::loadPressed() const { return keys[LOAD] && !prevKeys[LOAD]; }
 
 // Key hold functions - return true as long as the key is being held down
 bool InputHandler::leftHeld() const { return keys[LEFT]; }
 bool InputHandler::rightHeld() const { return keys[RIGHT]; }
 bool InputHandler::downHeld() const { return keys[DOWN]; }
-
-#ifndef _WIN32
-// Non-blocking keyboard check for Linux/macOS
-int InputHandler::kbhit()
-{
-    struct timeval tv = {0, 0};
-    fd_set readfds;
-    FD_ZERO(&readfds);
-    FD_SET(STDIN_FILENO, &readfds);
-    return select(1, &readfds, NULL, NULL, &tv);
-}
-
-// Single character input for Linux/macOS
-int InputHandler::getch()
-{
-    struct termios oldt, newt;
-    int ch;
-
-    tcgetattr(STDIN_FILENO, &oldt);
-    newt = oldt;
-    newt.c_lflag &= ~(ICANON | ECHO);
-    tcsetattr(STDIN_FILENO, TCSANOW, &newt);
-
-    ch = getchar();
-
-    tcsetattr(STDIN_FILENO, TCSANOW, &oldt);
-    return ch;
-}
-#endif
@@ -5,8 +5,7 @@
 #include <windows.h> // Windows-specific header for input handling
 #else
 #include <termios.h> // For controlling terminal I/O modes
-#include <unistd.h>  // For read(), usleep()
-#include <fcntl.h>   // For file control options
+#include <unistd.h>  // For read()
 #endif
 
 // Class for handling user input
@@ -23,12 +22,18 @@ public:
         HARD_DROP, // Instantly drop piece
         PAUSE,     // Pause the game
         QUIT,      // Quit the game
+        RESTART,   // Restart after game over
+        OVERLAY,   // Toggle the profiler overlay
+        SAVE,      // Save a checkpoint
+        LOAD,      // Resume from the checkpoint
         TOTAL_KEYS // Total number of keys
     };
 
-    InputHandler(); // Constructor
+    InputHandler();  // Constructor - puts the terminal into raw mode for the whole session
+    ~InputHandler(); // Destructor - restores the terminal
 
-    void update(); // Updates the state of keys
+    bool waitForInput(int timeoutMs); // Blocks until a key arrives or timeoutMs passes (-1 = no timeout)
+    void update();                    // Reads all pending input and updates the state of keys
 
     // Functions to check if a key was just pressed
     bool leftPressed() const;
@@ -38,6 +43,10 @@ public:
     bool hardDropPressed() const;
     bool pausePressed() const;
     bool quitPressed() const;
+    bool restartPressed() const;
+    bool overlayPressed() const;
+    bool savePressed() const;
+    bool loadPressed() const;
 
     // Functions to check if a key is being held down
     bool leftHeld() const;
@@ -49,8 +58,11 @@ private:
     bool prevKeys[TOTAL_KEYS]; // Previous state of keys
 
 #ifndef _WIN32
-    int kbhit(); // Check if a key has been hit
-    int getch(); // Get character from input
+    char pending[8];   // Start of an escape sequence split across reads
+    int pendingLength; // Bytes used in pending
+    bool endOfInput;   // stdin was closed; treated as a permanent quit
+
+    void parse(const char *bytes, int length, bool canWait); // Decodes raw bytes (canWait: keep a partial escape sequence)
 #endif
 };
 
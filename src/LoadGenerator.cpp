@@ -0,0 +1,256 @@
+#include "LoadGenerator.h"
+#include "Engine.h"
+#include "Protocol.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+
+#ifdef __linux__
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+// Constructor - clients are only created by run()
+LoadGenerator::LoadGenerator(const Settings &settings) : settings(settings)
+{
+}
+
+// Sessions, throughput and latency of the last run
+void LoadGenerator::printReport(std::ostream &out) const
+{
+    double seconds = report.seconds > 0 ? report.seconds : 1e-9;
+    out << "Sessions served: " << report.sessions << " (" << report.failedConnects << " refused, "
+        << report.dropped << " dropped mid-game)\n"
+        << "Inputs sent:     " << report.inputs << " (" << report.inputs / seconds << " per second)\n"
+        << "Deltas received: " << report.deltas << " (" << report.bytes << " bytes, " << report.protocolErrors
+        << " malformed)\n"
+        << "Input-to-state latency: p50 " << report.p50Us << " us, p99 " << report.p99Us << " us, max "
+        << report.maxUs << " us\n";
+}
+
+#ifdef __linux__
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+    // One simulated player
+    struct Client
+    {
+        int fd = -1;
+        bool connected = false;      // Received at least one delta on this connection
+        Protocol::Screen screen;     // The game as rebuilt from deltas
+        uint8_t buffer[2 * Protocol::MAX_DELTA];
+        size_t used = 0;             // Bytes of unparsed deltas in buffer
+        uint16_t sequence = 0;       // Sequence of the last input sent
+        bool waiting = false;        // An input is unacknowledged
+        Clock::time_point sentAt;    // When it was sent
+        Clock::time_point nextInput; // When the next one is due
+    };
+
+    // Blocking connect, then non-blocking I/O; -1 on failure
+    int connectTo(const sockaddr_un &address)
+    {
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0)
+            return -1;
+        if (connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0)
+        {
+            close(fd);
+            return -1;
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        return fd;
+    }
+
+    // Mostly moves and rotations, with a hard drop often enough that games end and restart
+    unsigned randomActions(std::mt19937 &random)
+    {
+        static const unsigned CHOICES[] = {Engine::MOVE_LEFT, Engine::MOVE_RIGHT, Engine::ROTATE, Engine::SOFT_DROP,
+                                           Engine::MOVE_LEFT, Engine::MOVE_RIGHT, Engine::ROTATE, Engine::HARD_DROP};
+        return CHOICES[random() % (sizeof(CHOICES) / sizeof(CHOICES[0]))];
+    }
+}
+
+// Connects every client, sends inputs at the configured rate and times their acknowledgements until
+// settings.seconds have passed
+bool LoadGenerator::run(const char *path)
+{
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (std::strlen(path) >= sizeof(address.sun_path))
+    {
+        std::cerr << "Socket path too long: " << path << "\n";
+        return false;
+    }
+    std::strcpy(address.sun_path, path);
+
+    int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0)
+        return false;
+
+    report = Report();
+    latenciesUs.clear();
+    latenciesUs.reserve(static_cast<size_t>(settings.clients * settings.seconds * settings.inputsPerSecond) + 1);
+    std::mt19937 random(settings.seed);
+    std::vector<Client> clients(settings.clients);
+    auto interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / settings.inputsPerSecond));
+
+    // (Re)connects a client and registers it; a client that cannot connect stays idle
+    auto connectClient = [&](Client &client)
+    {
+        client.fd = connectTo(address);
+        client.connected = false;
+        client.used = 0;
+        client.waiting = false;
+        Protocol::clear(client.screen);
+        if (client.fd < 0)
+        {
+            report.failedConnects++;
+            return;
+        }
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.ptr = &client;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, client.fd, &event);
+    };
+    auto disconnect = [&](Client &client)
+    {
+        close(client.fd);
+        client.fd = -1;
+    };
+
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < settings.clients; ++i)
+    {
+        connectClient(clients[i]);
+        clients[i].nextInput = start + interval * i / settings.clients; // Spread the clients over one interval
+    }
+
+    Clock::time_point end = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(settings.seconds));
+    epoll_event events[256];
+    while (Clock::now() < end)
+    {
+        int count = epoll_wait(epollFd, events, 256, 1);
+        Clock::time_point now = Clock::now();
+        for (int i = 0; i < count; ++i)
+        {
+            Client &client = *static_cast<Client *>(events[i].data.ptr);
+            if (client.fd < 0)
+                continue;
+            ssize_t got = read(client.fd, client.buffer + client.used, sizeof(client.buffer) - client.used);
+            if (got < 0 && (errno == EAGAIN || errno == EINTR))
+                continue;
+            if (got <= 0)
+            {
+                disconnect(client);
+                if (!client.connected)
+                {
+                    report.failedConnects++; // Refused: the server's pool was full
+                    continue;
+                }
+                report.dropped++;
+                connectClient(client); // Keep the offered load at settings.clients
+                continue;
+            }
+            client.used += static_cast<size_t>(got);
+            report.bytes += got;
+
+            // Apply every complete delta in the buffer
+            size_t offset = 0;
+            bool restart = false;
+            while (true)
+            {
+                size_t size = Protocol::messageSize(client.buffer + offset, client.used - offset);
+                if (size == 0 || client.used - offset < size)
+                    break;
+                uint16_t ack = 0;
+                uint8_t flags = 0;
+                if (size < Protocol::DELTA_HEADER || size > Protocol::MAX_DELTA ||
+                    !Protocol::applyDelta(client.buffer + offset, size, client.screen, ack, flags))
+                {
+                    report.protocolErrors++;
+                    restart = true;
+                    break;
+                }
+                offset += size;
+                report.deltas++;
+                if (!client.connected)
+                    report.sessions++; // First delta (the keyframe): the server has taken the session
+                client.connected = true;
+                if (client.waiting && ack == client.sequence)
+                {
+                    client.waiting = false;
+                    latenciesUs.push_back(std::chrono::duration<float, std::micro>(now - client.sentAt).count());
+                }
+                if (flags & Protocol::GAME_OVER)
+                    restart = true;
+            }
+            std::memmove(client.buffer, client.buffer + offset, client.used - offset);
+            client.used -= offset;
+
+            if (restart)
+            {
+                disconnect(client);
+                connectClient(client); // A new session for the next game
+            }
+        }
+
+        // Send the inputs that are due
+        for (Client &client : clients)
+        {
+            if (client.fd < 0 || !client.connected || client.waiting || now < client.nextInput)
+                continue;
+            if (++client.sequence == 0)
+                client.sequence = 1; // 0 is the acknowledgement of a session with no inputs yet
+            uint8_t message[Protocol::INPUT_SIZE];
+            Protocol::encodeInput(Protocol::INPUT, static_cast<uint8_t>(randomActions(random)), client.sequence, message);
+            if (send(client.fd, message, sizeof(message), MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(message)))
+            {
+                disconnect(client);
+                report.dropped++;
+                connectClient(client);
+                continue;
+            }
+            report.inputs++;
+            client.waiting = true;
+            client.sentAt = now;
+            client.nextInput += interval;
+            if (client.nextInput < now)
+                client.nextInput = now + interval; // Fell behind: keep the rate, drop the missed inputs
+        }
+    }
+    report.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    for (Client &client : clients)
+        if (client.fd >= 0)
+            disconnect(client);
+    close(epollFd);
+
+    if (!latenciesUs.empty())
+    {
+        std::sort(latenciesUs.begin(), latenciesUs.end());
+        size_t count = latenciesUs.size();
+        report.p50Us = latenciesUs[(count - 1) / 2];
+        report.p99Us = latenciesUs[count - 1 - count / 100];
+        report.maxUs = latenciesUs.back();
+    }
+    return report.sessions > 0;
+}
+
+#else
+
+// Reports that the load generator is unavailable (epoll is Linux only)
+bool LoadGenerator::run(const char *)
+{
+    std::cerr << "The load generator needs Linux (epoll)\n";
+    return false;
+}
+
+#endif
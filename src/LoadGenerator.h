@@ -0,0 +1,51 @@
+#ifndef LOAD_GENERATOR_H
+#define LOAD_GENERATOR_H
+
+#include <ostream>
+#include <vector>
+
+// LoadGenerator drives a GameServer with many simulated players from one thread. Each client sends
+// a random input at a fixed rate, waits for the delta that acknowledges it and records the
+// input-to-state latency. A client whose game ends disconnects and connects again, so sessions
+// keep being taken from and returned to the server's pool during the run.
+class LoadGenerator
+{
+public:
+    struct Settings
+    {
+        int clients = 100;        // Players connected at once
+        double seconds = 10;      // Length of the run
+        int inputsPerSecond = 50; // Inputs each client sends (at most one in flight)
+        unsigned seed = 1;        // Seed of the random inputs
+    };
+
+    struct Report
+    {
+        long sessions = 0;       // Sessions the server accepted and answered (reconnections included)
+        long failedConnects = 0; // Connections refused or closed before the first delta
+        long dropped = 0;        // Sessions the server closed mid-game (the client reconnected)
+        long inputs = 0;         // Inputs sent
+        long deltas = 0;         // Deltas received
+        long long bytes = 0;     // Delta bytes received
+        long protocolErrors = 0; // Malformed deltas
+        double seconds = 0;      // Measured run time
+        double p50Us = 0;        // Input-to-state latency percentiles
+        double p99Us = 0;
+        double maxUs = 0;
+    };
+
+    explicit LoadGenerator(const Settings &settings); // Constructor
+
+    // Runs against the server listening at path; false if no client could connect at all
+    bool run(const char *path);
+
+    const Report &getReport() const { return report; }
+    void printReport(std::ostream &out) const;
+
+private:
+    Settings settings;
+    Report report;
+    std::vector<float> latenciesUs; // One entry per acknowledged input
+};
+
+#endif
@@ -0,0 +1,79 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <fstream>
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Constructor - nothing mapped yet
+MappedFile::MappedFile() : bytes(nullptr), length(0) {}
+
+// Destructor - release the mapping
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+// Map (or on Windows, read) the whole file
+bool MappedFile::open(const char *path)
+{
+    close();
+#ifdef _WIN32
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+    contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    bytes = contents.data();
+    length = contents.size();
+    return true;
+#else
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    length = static_cast<size_t>(info.st_size);
+    if (length > 0)
+    {
+        void *mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED)
+        {
+            ::close(fd);
+            length = 0;
+            return false;
+        }
+        bytes = static_cast<const uint8_t *>(mapping);
+    }
+    else
+    {
+        static const uint8_t empty = 0;
+        bytes = &empty; // Valid pointer for an empty file
+    }
+    ::close(fd); // The mapping stays valid after the descriptor is closed
+    return true;
+#endif
+}
+
+// Unmap the file
+void MappedFile::close()
+{
+#ifdef _WIN32
+    contents.clear();
+#else
+    if (bytes != nullptr && length > 0)
+        munmap(const_cast<uint8_t *>(bytes), length);
+#endif
+    bytes = nullptr;
+    length = 0;
+}
@@ -0,0 +1,33 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// MappedFile gives read-only access to a whole file. On Linux/macOS the file is memory-mapped,
+// so opening costs the same no matter how large it is; on Windows it is read into memory.
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool open(const char *path); // Maps the file, returns false if it cannot be opened
+    void close();                // Unmaps the file
+
+    const uint8_t *data() const { return bytes; }
+    size_t size() const { return length; }
+
+private:
+    const uint8_t *bytes; // Start of the file contents (nullptr when closed)
+    size_t length;        // File size in bytes
+#ifdef _WIN32
+    std::vector<uint8_t> contents; // Fallback copy of the file
+#endif
+};
+
+#endif
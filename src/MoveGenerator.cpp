@@ -0,0 +1,115 @@
+#include "MoveGenerator.h"
+#include "Engine.h"
+
+// Constructor - storage is reused by every generate() call
+MoveGenerator::MoveGenerator() : placementCount(0), statesVisited(0) {}
+
+// Breadth-first search over piece states; every state where the piece cannot move down is a placement
+int MoveGenerator::generate(const Board &board, const Tetromino &start)
+{
+    static const unsigned MOVES[] = {Engine::MOVE_LEFT, Engine::MOVE_RIGHT, Engine::SOFT_DROP, Engine::ROTATE};
+
+    visited.reset();
+    placementCount = 0;
+    statesVisited = 0;
+    if (board.isCollision(start))
+        return 0;
+
+    int head = 0;
+    int tail = 0;
+    nodes[tail++] = {static_cast<int8_t>(start.getX()), static_cast<int8_t>(start.getY()),
+                     static_cast<int8_t>(start.getRotation()), 0, -1};
+    visited.set(stateIndex(start));
+
+    Tetromino piece = start;
+    while (head < tail)
+    {
+        const int current = head++;
+        const Node node = nodes[current];
+        statesVisited++;
+
+        piece.setPosition(node.x, node.y);
+        while (piece.getRotation() != node.rotation)
+            piece.rotate();
+
+        // Resting state: record it unless the same cells were already found
+        Tetromino below = piece;
+        if (!board.movePiece(below, 0, 1))
+        {
+            uint32_t key = cellKey(piece);
+            bool duplicate = false;
+            for (int i = 0; i < placementCount && !duplicate; ++i)
+                duplicate = placements[i].key == key;
+            if (!duplicate)
+                placements[placementCount++] = {piece, key, static_cast<int16_t>(current)};
+        }
+
+        for (unsigned move : MOVES)
+        {
+            Tetromino next = piece;
+            bool moved = move == Engine::MOVE_LEFT    ? board.movePiece(next, -1, 0)
+                         : move == Engine::MOVE_RIGHT ? board.movePiece(next, 1, 0)
+                         : move == Engine::SOFT_DROP  ? board.movePiece(next, 0, 1)
+                                                      : board.rotatePiece(next);
+            if (!moved)
+                continue;
+
+            int index = stateIndex(next);
+            if (visited.test(index))
+                continue;
+            visited.set(index);
+            nodes[tail++] = {static_cast<int8_t>(next.getX()), static_cast<int8_t>(next.getY()),
+                             static_cast<int8_t>(next.getRotation()), static_cast<uint8_t>(move),
+                             static_cast<int16_t>(current)};
+        }
+    }
+    return placementCount;
+}
+
+// Rebuilds the input sequence for a placement by walking the BFS parents back to the start
+int MoveGenerator::getPath(int index, unsigned *actions, int maxActions) const
+{
+    int length = 0;
+    for (int node = placements[index].node; nodes[node].parent >= 0; node = nodes[node].parent)
+        length++;
+    if (length + 1 > maxActions)
+        return -1;
+
+    int position = length;
+    actions[position] = Engine::HARD_DROP; // Lock in place (the piece is already resting)
+    for (int node = placements[index].node; nodes[node].parent >= 0; node = nodes[node].parent)
+        actions[--position] = nodes[node].action;
+    return length + 1;
+}
+
+// Looks a placement up by the cells it covers, so any rotation with the same footprint matches
+int MoveGenerator::find(const Tetromino &piece) const
+{
+    uint32_t key = cellKey(piece);
+    for (int i = 0; i < placementCount; ++i)
+    {
+        if (placements[i].key == key)
+            return i;
+    }
+    return -1;
+}
+
+// Maps a legal piece state to its bit in the visited set
+int MoveGenerator::stateIndex(const Tetromino &piece)
+{
+    return (piece.getRotation() * Y_RANGE + piece.getY() + Y_OFFSET) * X_RANGE + piece.getX() + X_OFFSET;
+}
+
+// Packs the covered cells as (top row, left column, row masks of the bounding box)
+uint32_t MoveGenerator::cellKey(const Tetromino &piece)
+{
+    const PieceShape &shape = piece.getShape();
+    uint32_t key = static_cast<uint32_t>(piece.getY() + shape.minY + Y_OFFSET);
+    key = (key << 5) | static_cast<uint32_t>(piece.getX() + shape.minX + X_OFFSET);
+    for (int dy = shape.minY; dy < shape.minY + PieceShape::SIZE; ++dy)
+    {
+        uint32_t row = dy < PieceShape::SIZE ? static_cast<uint32_t>(shape.rowMasks[dy] >> shape.minX) : 0;
+        key = (key << 4) | row;
+    }
+    return key;
+}
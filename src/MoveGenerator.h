@@ -0,0 +1,65 @@
+#ifndef MOVE_GENERATOR_H
+#define MOVE_GENERATOR_H
+
+#include "Board.h"
+#include "Tetromino.h"
+#include <bitset>
+#include <cstdint>
+
+// MoveGenerator finds every distinct resting placement of a piece, including placements that
+// are only reachable by sliding or rotating under overhangs. It runs a breadth-first search over
+// (x, y, rotation) using Board::movePiece / Board::rotatePiece, so it follows the game's own rules.
+// All storage is fixed-size: generate() never allocates.
+class MoveGenerator
+{
+public:
+    // State space covered by the visited bitset (positions a piece can legally occupy plus margin)
+    static const int X_OFFSET = 3;
+    static const int X_RANGE = Board::WIDTH + 2 * X_OFFSET;
+    static const int Y_OFFSET = 4;
+    static const int Y_RANGE = Board::HEIGHT + Y_OFFSET;
+    static const int MAX_STATES = 4 * X_RANGE * Y_RANGE;
+
+    static const int MAX_PLACEMENTS = 4 * Board::WIDTH * Board::HEIGHT; // Upper bound on resting placements
+
+    MoveGenerator();
+
+    int generate(const Board &board, const Tetromino &piece); // Finds all placements, returns how many
+
+    int getCount() const { return placementCount; }                                    // Placements found by generate()
+    const Tetromino &getPlacement(int index) const { return placements[index].piece; } // Piece at its resting spot
+    int find(const Tetromino &piece) const;                                            // Placement covering the same cells as piece (-1 if none)
+
+    // Writes the Engine actions (one per input, ending with a hard drop) that take the piece from its
+    // starting position to the placement. Returns the number of actions, or -1 if maxActions is too small.
+    int getPath(int index, unsigned *actions, int maxActions) const;
+
+    long getStatesVisited() const { return statesVisited; } // States expanded by the last generate()
+
+private:
+    // One BFS node: a reachable piece state and the move that first reached it
+    struct Node
+    {
+        int8_t x, y, rotation;
+        uint8_t action; // Engine::Action used to get here (0 for the start)
+        int16_t parent; // Index of the previous node (-1 for the start)
+    };
+
+    struct Placement
+    {
+        Tetromino piece = Tetromino(Tetromino::I); // Piece at rest
+        uint32_t key;                              // Identifies the occupied cells, to merge rotations that look the same
+        int16_t node;                              // Node that reached it first (shortest path)
+    };
+
+    std::bitset<MAX_STATES> visited;      // States already queued
+    Node nodes[MAX_STATES];               // BFS queue; every node stays in place for path reconstruction
+    Placement placements[MAX_PLACEMENTS]; // Distinct placements found
+    int placementCount;                   // Entries used in placements
+    long statesVisited;                   // States expanded by the last search
+
+    static int stateIndex(const Tetromino &piece);   // Position of a state in the visited bitset
+    static uint32_t cellKey(const Tetromino &piece); // Key of the cells a piece covers
+};
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef OBJECT_POOL_H
+#define OBJECT_POOL_H
+
+#include <memory>
+#include <vector>
+
+// ObjectPool hands out objects from a block allocated once up front. acquire() and release() only
+// move an index on a free list, so taking an object never touches the global allocator. Objects are
+// constructed once with the pool and reused as they are; callers reset whatever state they need.
+template <typename T>
+class ObjectPool
+{
+public:
+    explicit ObjectPool(int capacity) : objects(new T[capacity]), capacity(capacity)
+    {
+        freeList.reserve(capacity);
+        for (int i = capacity - 1; i >= 0; --i)
+            freeList.push_back(i); // Lowest index first
+    }
+
+    ObjectPool(const ObjectPool &) = delete;
+    ObjectPool &operator=(const ObjectPool &) = delete;
+
+    // Takes a free object, or nullptr when all are in use
+    T *acquire()
+    {
+        if (freeList.empty())
+            return nullptr;
+        int index = freeList.back();
+        freeList.pop_back();
+        return &objects[index];
+    }
+
+    // Returns an object taken with acquire()
+    void release(T *object)
+    {
+        freeList.push_back(static_cast<int>(object - objects.get()));
+    }
+
+    int getCapacity() const { return capacity; }
+    int getInUse() const { return capacity - static_cast<int>(freeList.size()); }
+
+private:
+    std::unique_ptr<T[]> objects;
+    std::vector<int> freeList; // Indices of unused objects (reserved up front, so it never reallocates)
+    int capacity;
+};
+
+#endif
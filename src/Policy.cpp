@@ -0,0 +1,34 @@
+#include "Policy.h"
+
+// Constructor - default seed until reset() is called
+RandomPolicy::RandomPolicy() : rng(0) {}
+
+// Reseed for a new game
+void RandomPolicy::reset(unsigned seed)
+{
+    rng.seed(seed ^ 0x9E3779B9u); // Decorrelate from the engine's piece generator
+}
+
+// Mostly moves and rotates, with an occasional hard drop
+unsigned RandomPolicy::chooseActions(const Engine &)
+{
+    switch (rng() % 16)
+    {
+    case 0:
+    case 1:
+    case 2:
+        return Engine::MOVE_LEFT;
+    case 3:
+    case 4:
+    case 5:
+        return Engine::MOVE_RIGHT;
+    case 6:
+    case 7:
+        return Engine::ROTATE;
+    case 8:
+        return Engine::SOFT_DROP;
+    case 9:
+        return Engine::HARD_DROP;
+    }
+    return 0; // Let gravity do the work
+}
@@ -0,0 +1,30 @@
+#ifndef POLICY_H
+#define POLICY_H
+
+#include "Engine.h"
+#include <random>
+
+// Policy decides which actions a headless game takes each frame (bots implement this)
+class Policy
+{
+public:
+    virtual ~Policy() {}
+
+    virtual void reset(unsigned seed) = 0;                    // Called before every new game
+    virtual unsigned chooseActions(const Engine &engine) = 0; // Engine::Action bitmask for the next frame
+};
+
+// RandomPolicy presses random keys; a baseline bot and a cheap way to exercise the rules
+class RandomPolicy : public Policy
+{
+public:
+    RandomPolicy();
+
+    void reset(unsigned seed) override;
+    unsigned chooseActions(const Engine &engine) override;
+
+private:
+    std::mt19937 rng; // Per-game generator so parallel games stay independent
+};
+
+#endif
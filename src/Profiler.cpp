@@ -0,0 +1,186 @@
+#include "Profiler.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifndef _WIN32
+#include <csignal>
+#include <pthread.h>
+#include <thread>
+#endif
+
+Profiler::StageData Profiler::stages[Profiler::STAGE_COUNT];
+
+namespace
+{
+    char reportPath[512]; // Set by install(); empty = no report
+
+    // Names in Stage order
+    const char *const STAGE_NAMES[] = {"input", "process input", "gravity", "clear lines", "render", "sleep", "search"};
+    static_assert(sizeof(STAGE_NAMES) / sizeof(STAGE_NAMES[0]) == Profiler::STAGE_COUNT, "every stage needs a name");
+
+    void writeAtExit()
+    {
+        Profiler::writeReport(reportPath);
+    }
+
+#ifndef _WIN32
+    // Waits for SIGUSR1 and writes the report each time it arrives (the signal is blocked in every
+    // other thread, so sigwait receives it here instead of a handler interrupting the game)
+    void dumpOnSignal()
+    {
+        sigset_t set;
+        sigemptyset(&set);
+        sigaddset(&set, SIGUSR1);
+        while (true)
+        {
+            int signal = 0;
+            if (sigwait(&set, &signal) == 0 && signal == SIGUSR1)
+                Profiler::writeReport(reportPath);
+        }
+    }
+#endif
+}
+
+// Registers the report file. Must run before any other thread starts, so that all of them inherit
+// the blocked SIGUSR1.
+void Profiler::install(const char *path)
+{
+    std::snprintf(reportPath, sizeof(reportPath), "%s", path);
+    std::atexit(writeAtExit);
+
+#ifndef _WIN32
+    sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, SIGUSR1);
+    pthread_sigmask(SIG_BLOCK, &set, nullptr);
+    std::thread(dumpOnSignal).detach();
+#endif
+}
+
+// Current time for Scope (steady_clock, so measurements never go backwards)
+uint64_t Profiler::now()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+}
+
+// Relaxed atomics are enough: the counters are independent and only read for reports
+void Profiler::record(Stage stage, uint64_t ns)
+{
+    StageData &data = stages[stage];
+    data.count.fetch_add(1, std::memory_order_relaxed);
+    data.totalNs.fetch_add(ns, std::memory_order_relaxed);
+    data.buckets[bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t max = data.maxNs.load(std::memory_order_relaxed);
+    while (ns > max && !data.maxNs.compare_exchange_weak(max, ns, std::memory_order_relaxed))
+        ;
+}
+
+// Values below 1 << SUB_BITS get a bucket each; above that, each power of two is split into
+// 1 << SUB_BITS equal parts by the bits just below the leading one
+int Profiler::bucketOf(uint64_t ns)
+{
+    const uint64_t SUB = 1u << SUB_BITS;
+    if (ns < SUB)
+        return static_cast<int>(ns);
+#if defined(__GNUC__)
+    int exponent = 63 - __builtin_clzll(ns);
+#else
+    int exponent = 0;
+    while ((ns >> exponent) > 1)
+        ++exponent;
+#endif
+    return ((exponent - SUB_BITS + 1) << SUB_BITS) | static_cast<int>((ns >> (exponent - SUB_BITS)) & (SUB - 1));
+}
+
+// Largest value that bucketOf maps to bucket (the inverse of bucketOf, rounded up)
+uint64_t Profiler::bucketLimit(int bucket)
+{
+    const int SUB = 1 << SUB_BITS;
+    if (bucket < SUB)
+        return static_cast<uint64_t>(bucket);
+    int exponent = (bucket >> SUB_BITS) + SUB_BITS - 1;
+    uint64_t width = uint64_t(1) << (exponent - SUB_BITS);
+    uint64_t lower = static_cast<uint64_t>(SUB + (bucket & (SUB - 1))) << (exponent - SUB_BITS);
+    return lower + width - 1;
+}
+
+// Reads a stage's counters; percentiles are reported as the upper edge of their bucket (capped at the max)
+Profiler::Summary Profiler::summarize(Stage stage)
+{
+    StageData &data = stages[stage];
+    Summary summary;
+    summary.count = data.count.load(std::memory_order_relaxed);
+    summary.maxNs = data.maxNs.load(std::memory_order_relaxed);
+    summary.meanNs = summary.count > 0 ? data.totalNs.load(std::memory_order_relaxed) / summary.count : 0;
+    summary.p50Ns = summary.p99Ns = 0;
+
+    bool p50Found = false;
+    uint64_t p50Rank = (summary.count + 1) / 2;
+    uint64_t p99Rank = summary.count - summary.count / 100;
+    uint64_t seen = 0;
+    for (int bucket = 0; bucket < BUCKETS && seen < p99Rank; ++bucket)
+    {
+        uint64_t inBucket = data.buckets[bucket].load(std::memory_order_relaxed);
+        if (inBucket == 0)
+            continue;
+        seen += inBucket;
+        uint64_t limit = bucketLimit(bucket) < summary.maxNs ? bucketLimit(bucket) : summary.maxNs;
+        if (!p50Found && seen >= p50Rank)
+        {
+            summary.p50Ns = limit;
+            p50Found = true;
+        }
+        if (seen >= p99Rank)
+            summary.p99Ns = limit;
+    }
+    return summary;
+}
+
+// Writes one line per stage, in microseconds
+bool Profiler::writeReport(const char *path)
+{
+    if (path == nullptr || path[0] == '\0')
+        return false;
+    FILE *file = std::fopen(path, "w");
+    if (file == nullptr)
+        return false;
+
+    std::fprintf(file, "%-14s %12s %12s %12s %12s %12s\n", "stage", "count", "mean us", "p50 us", "p99 us", "max us");
+    for (int stage = 0; stage < STAGE_COUNT; ++stage)
+    {
+        Summary summary = summarize(static_cast<Stage>(stage));
+        std::fprintf(file, "%-14s %12llu %12.3f %12.3f %12.3f %12.3f\n", STAGE_NAMES[stage],
+                     static_cast<unsigned long long>(summary.count), summary.meanNs / 1000.0,
+                     summary.p50Ns / 1000.0, summary.p99Ns / 1000.0, summary.maxNs / 1000.0);
+    }
+    return std::fclose(file) == 0;
+}
+
+// One short line per stage that has been recorded, for the overlay next to the board
+void Profiler::formatOverlay(char *out, size_t size)
+{
+    size_t used = 0;
+    out[0] = '\0';
+    for (int stage = 0; stage < STAGE_COUNT && used < size; ++stage)
+    {
+        Summary summary = summarize(static_cast<Stage>(stage));
+        if (summary.count == 0)
+            continue;
+        int written = std::snprintf(out + used, size - used, "%-13s p50 %8.1f p99 %8.1f us\n", STAGE_NAMES[stage],
+                                    summary.p50Ns / 1000.0, summary.p99Ns / 1000.0);
+        if (written < 0)
+            break;
+        used += static_cast<size_t>(written);
+    }
+}
+
+// Short name of a stage for reports
+const char *Profiler::stageName(Stage stage)
+{
+    return STAGE_NAMES[stage];
+}
@@ -0,0 +1,100 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Profiler keeps a call counter and a latency histogram for each stage of the game loop. It is
+// compiled in only with -DTETRIS_PROFILE; otherwise PROFILE_SCOPE expands to nothing and no stage
+// is ever timed, so normal builds pay nothing.
+//
+// Recording is lock-free: every stage is a set of relaxed atomic counters, so any thread (search
+// threads clearing lines, for instance) can record at the same time. Histogram buckets are fixed
+// and logarithmic with four sub-buckets per power of two, so a percentile is exact to within 25%.
+//
+// The report is written to a file when the program exits and whenever the process receives
+// SIGUSR1 (a background thread waits for the signal, so nothing runs inside a signal handler).
+class Profiler
+{
+public:
+#ifdef TETRIS_PROFILE
+    static constexpr bool ENABLED = true;
+#else
+    static constexpr bool ENABLED = false;
+#endif
+
+    // Instrumented stages
+    enum Stage
+    {
+        INPUT,         // InputHandler::update
+        PROCESS_INPUT, // Game::processInput
+        GRAVITY,       // One engine frame (gravity, plus the bot's actions in autoplay)
+        CLEAR_LINES,   // Board::clearFullLines
+        RENDER,        // RenderThread drawing one frame
+        SLEEP,         // Waiting for input or the next tick
+        SEARCH,        // AutoPlayer search for one piece
+        STAGE_COUNT
+    };
+
+    // Summary of one stage, in nanoseconds
+    struct Summary
+    {
+        uint64_t count;
+        uint64_t meanNs;
+        uint64_t p50Ns;
+        uint64_t p99Ns;
+        uint64_t maxNs;
+    };
+
+    // Times the enclosing scope into a stage
+    class Scope
+    {
+    public:
+        explicit Scope(Stage stage) : stage(stage), began(now()) {}
+        ~Scope() { record(stage, now() - began); }
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        Stage stage;
+        uint64_t began;
+    };
+
+    static void install(const char *path);             // Sets the report file, writes it at exit and on SIGUSR1
+    static void record(Stage stage, uint64_t ns);      // Adds one measurement
+    static Summary summarize(Stage stage);             // Current counters of a stage
+    static bool writeReport(const char *path);         // Writes all stages as a table
+    static void formatOverlay(char *out, size_t size); // Short per-stage lines for the on-screen overlay ('\n' separated)
+    static const char *stageName(Stage stage);
+    static uint64_t now();                             // steady_clock in nanoseconds
+
+private:
+    static const int SUB_BITS = 2;                    // Sub-buckets per power of two = 1 << SUB_BITS
+    static const int BUCKETS = (64 - SUB_BITS + 1) << SUB_BITS;
+
+    // Counters of one stage on their own cache lines, so stages recorded by different threads do not collide
+    struct alignas(64) StageData
+    {
+        std::atomic<uint64_t> count;
+        std::atomic<uint64_t> totalNs;
+        std::atomic<uint64_t> maxNs;
+        std::atomic<uint64_t> buckets[BUCKETS];
+    };
+
+    static StageData stages[STAGE_COUNT];
+
+    static int bucketOf(uint64_t ns);        // Histogram bucket of a measurement
+    static uint64_t bucketLimit(int bucket); // Largest value that falls into a bucket
+};
+
+#ifdef TETRIS_PROFILE
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(stage) Profiler::Scope PROFILE_CONCAT(profileScope, __LINE__)(Profiler::stage)
+#else
+#define PROFILE_SCOPE(stage) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,158 @@
+#include "Protocol.h"
+#include <cstring>
+
+namespace Protocol
+{
+    namespace
+    {
+        bool movedPiece(const Screen &a, const Screen &b)
+        {
+            return a.piece != b.piece || a.rotation != b.rotation || a.pieceX != b.pieceX || a.pieceY != b.pieceY;
+        }
+    }
+
+    // Starting state of every receiver: empty cells and no score
+    void clear(Screen &screen)
+    {
+        std::memset(screen.cells, ' ', sizeof(screen.cells));
+        screen.score = 0;
+        screen.level = 0;
+        screen.next = ' ';
+        screen.piece = ' ';
+        screen.rotation = 0;
+        screen.pieceX = screen.pieceY = 0;
+        screen.gameOver = false;
+    }
+
+    void capture(const Engine &engine, Screen &screen)
+    {
+        engine.getBoard().copyCells(engine.getCurrentPiece(), screen.cells);
+        screen.score = engine.getScore();
+        screen.level = static_cast<uint8_t>(engine.getLevel() < 255 ? engine.getLevel() : 255);
+        screen.next = Tetromino::typeChar(engine.getNextPiece(0));
+        const Tetromino &piece = engine.getCurrentPiece();
+        screen.piece = Tetromino::typeChar(piece.getType());
+        screen.rotation = static_cast<uint8_t>(piece.getRotation());
+        screen.pieceX = static_cast<int8_t>(piece.getX());
+        screen.pieceY = static_cast<int8_t>(piece.getY());
+        screen.gameOver = engine.isGameOver();
+    }
+
+    bool same(const Screen &a, const Screen &b)
+    {
+        return std::memcmp(a.cells, b.cells, sizeof(a.cells)) == 0 && a.score == b.score && a.level == b.level &&
+               a.next == b.next && !movedPiece(a, b) && a.gameOver == b.gameOver;
+    }
+
+    // Header first, then the optional fields, then the changed cells in row order
+    size_t encodeDelta(const Screen &previous, const Screen &current, uint16_t ack, bool keyframe, uint8_t *out)
+    {
+        uint8_t flags = keyframe ? KEYFRAME : 0;
+        if (keyframe || current.score != previous.score)
+            flags |= SCORE;
+        if (keyframe || current.level != previous.level)
+            flags |= LEVEL;
+        if (keyframe || current.next != previous.next)
+            flags |= NEXT;
+        if (keyframe || movedPiece(current, previous))
+            flags |= PIECE;
+        if (current.gameOver)
+            flags |= GAME_OVER;
+
+        size_t size = DELTA_HEADER;
+        if (flags & SCORE)
+        {
+            std::memcpy(out + size, &current.score, sizeof(current.score));
+            size += sizeof(current.score);
+        }
+        if (flags & LEVEL)
+            out[size++] = current.level;
+        if (flags & NEXT)
+            out[size++] = static_cast<uint8_t>(current.next);
+        if (flags & PIECE)
+        {
+            out[size++] = static_cast<uint8_t>(current.piece);
+            out[size++] = current.rotation;
+            out[size++] = static_cast<uint8_t>(current.pieceX);
+            out[size++] = static_cast<uint8_t>(current.pieceY);
+        }
+
+        int cellCount = 0;
+        const char *now = &current.cells[0][0];
+        const char *before = &previous.cells[0][0];
+        for (int index = 0; index < Board::WIDTH * Board::HEIGHT; ++index)
+        {
+            if (!keyframe && now[index] == before[index])
+                continue;
+            out[size++] = static_cast<uint8_t>(index);
+            out[size++] = static_cast<uint8_t>(now[index]);
+            cellCount++;
+        }
+
+        uint16_t total = static_cast<uint16_t>(size);
+        std::memcpy(out, &total, sizeof(total));
+        out[2] = flags;
+        std::memcpy(out + 3, &ack, sizeof(ack));
+        out[5] = static_cast<uint8_t>(cellCount);
+        return size;
+    }
+
+    // Checks every length against the message size before reading, so a bad sender cannot overrun
+    bool applyDelta(const uint8_t *data, size_t size, Screen &screen, uint16_t &ack, uint8_t &flags)
+    {
+        if (size < DELTA_HEADER || messageSize(data, size) != size)
+            return false;
+        flags = data[2];
+        std::memcpy(&ack, data + 3, sizeof(ack));
+        int cellCount = data[5];
+
+        size_t offset = DELTA_HEADER;
+        size_t fields = ((flags & SCORE) ? 4 : 0) + ((flags & LEVEL) ? 1 : 0) + ((flags & NEXT) ? 1 : 0) +
+                        ((flags & PIECE) ? 4 : 0);
+        if (offset + fields + 2 * static_cast<size_t>(cellCount) != size)
+            return false;
+
+        if (flags & SCORE)
+        {
+            std::memcpy(&screen.score, data + offset, sizeof(screen.score));
+            offset += sizeof(screen.score);
+        }
+        if (flags & LEVEL)
+            screen.level = data[offset++];
+        if (flags & NEXT)
+            screen.next = static_cast<char>(data[offset++]);
+        if (flags & PIECE)
+        {
+            screen.piece = static_cast<char>(data[offset++]);
+            screen.rotation = data[offset++];
+            screen.pieceX = static_cast<int8_t>(data[offset++]);
+            screen.pieceY = static_cast<int8_t>(data[offset++]);
+        }
+        screen.gameOver = (flags & GAME_OVER) != 0;
+
+        char *cells = &screen.cells[0][0];
+        for (int i = 0; i < cellCount; ++i, offset += 2)
+        {
+            if (data[offset] >= Board::WIDTH * Board::HEIGHT)
+                return false;
+            cells[data[offset]] = static_cast<char>(data[offset + 1]);
+        }
+        return true;
+    }
+
+    size_t messageSize(const uint8_t *data, size_t available)
+    {
+        if (available < 2)
+            return 0;
+        uint16_t size;
+        std::memcpy(&size, data, sizeof(size));
+        return size;
+    }
+
+    void encodeInput(uint8_t type, uint8_t actions, uint16_t sequence, uint8_t *out)
+    {
+        out[0] = type;
+        out[1] = actions;
+        std::memcpy(out + 2, &sequence, sizeof(sequence));
+    }
+}
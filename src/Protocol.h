@@ -0,0 +1,74 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include "Engine.h"
+#include <cstddef>
+#include <cstdint>
+
+// Binary messages between the game server and its clients (and, for deltas, between a broadcasting
+// game and its viewers). Both ends run on the same machine, so integers are sent in native byte order.
+//
+// Client to server, fixed 4 bytes: type (uint8), Engine::Action mask (uint8), sequence (uint16).
+// Server to client, one delta per state change:
+//   size (uint16, whole message)  flags (uint8)  ack (uint16, last input sequence applied)
+//   cell count (uint8)  [score (int32) if SCORE]  [level (uint8) if LEVEL]  [next piece (char) if NEXT]
+//   [piece (char), rotation (uint8), x (int8), y (int8) if PIECE]
+//   cell count x (index (uint8) = y * WIDTH + x, cell character)
+// The cells include the falling piece, so a client only ever patches its copy of the screen; the
+// PIECE field is there for receivers that draw the piece themselves.
+namespace Protocol
+{
+    // Client message types
+    enum ClientMessage : uint8_t
+    {
+        INPUT = 1,  // Apply the actions now
+        RESTART = 2 // Start a new game in the same session
+    };
+
+    // Delta flags
+    enum DeltaFlag : uint8_t
+    {
+        SCORE = 1 << 0,     // Score field present
+        LEVEL = 1 << 1,     // Level field present
+        NEXT = 1 << 2,      // Next-piece field present
+        GAME_OVER = 1 << 3, // The game has ended
+        KEYFRAME = 1 << 4,  // Every field and cell is present (the receiver may start from here)
+        PIECE = 1 << 5      // Falling-piece field present
+    };
+
+    const size_t INPUT_SIZE = 4;   // Bytes per client message
+    const size_t DELTA_HEADER = 6; // size, flags, ack, cell count
+    const size_t MAX_DELTA = DELTA_HEADER + 4 + 1 + 1 + 4 + 2 * Board::WIDTH * Board::HEIGHT; // Largest delta (a keyframe)
+
+    // What a client sees of a game
+    struct Screen
+    {
+        char cells[Board::HEIGHT][Board::WIDTH]; // Board with the falling piece overlaid
+        int32_t score;
+        uint8_t level;
+        char next;     // Next piece character
+        char piece;    // Falling piece character
+        uint8_t rotation;
+        int8_t pieceX; // Position of the piece's 4x4 box
+        int8_t pieceY;
+        bool gameOver;
+    };
+
+    void clear(Screen &screen);                        // Empty board, zero score (what a receiver starts from)
+    void capture(const Engine &engine, Screen &screen); // What a client of this game should see now
+    bool same(const Screen &a, const Screen &b);        // Whether a delta between the two would be empty
+
+    // Writes the delta that turns previous into current into out (MAX_DELTA bytes); returns its size.
+    // A keyframe ignores previous and carries everything.
+    size_t encodeDelta(const Screen &previous, const Screen &current, uint16_t ack, bool keyframe, uint8_t *out);
+
+    // Applies one complete delta to screen; returns false if the message is malformed
+    bool applyDelta(const uint8_t *data, size_t size, Screen &screen, uint16_t &ack, uint8_t &flags);
+
+    // Size of the message starting at data, or 0 if fewer than 2 bytes are available
+    size_t messageSize(const uint8_t *data, size_t available);
+
+    void encodeInput(uint8_t type, uint8_t actions, uint16_t sequence, uint8_t *out); // INPUT_SIZE bytes
+}
+
+#endif
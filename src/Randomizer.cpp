@@ -0,0 +1,120 @@
+#include "Randomizer.h"
+
+// Constructor - seed the generator and compute the preview queue
+Randomizer::Randomizer(uint64_t seed, Mode mode)
+{
+    reset(seed, mode);
+}
+
+// Restart the sequence from a seed
+void Randomizer::reset(uint64_t seed, Mode newMode)
+{
+    state = seed;
+    mode = newMode;
+    bagIndex = 7; // Empty bag, refilled on first draw
+    for (int i = 0; i < 7; ++i)
+        bag[i] = static_cast<uint8_t>(i);
+
+    queueHead = 0;
+    for (int i = 0; i < PREVIEW; ++i)
+        queue[i] = static_cast<uint8_t>(generate());
+}
+
+// Take the next piece and draw a replacement at the back of the queue
+Tetromino::Type Randomizer::next()
+{
+    Tetromino::Type piece = static_cast<Tetromino::Type>(queue[queueHead]);
+    queue[queueHead] = static_cast<uint8_t>(generate());
+    queueHead = (queueHead + 1) % PREVIEW;
+    return piece;
+}
+
+// Look ahead without consuming
+Tetromino::Type Randomizer::peek(int index) const
+{
+    return static_cast<Tetromino::Type>(queue[(queueHead + index) % PREVIEW]);
+}
+
+// Copies the generator, bag and preview queue out for a checkpoint
+void Randomizer::save(State &out) const
+{
+    out.state = state;
+    out.mode = static_cast<uint8_t>(mode);
+    out.bagIndex = static_cast<uint8_t>(bagIndex);
+    out.queueHead = static_cast<uint8_t>(queueHead);
+    for (int i = 0; i < 7; ++i)
+        out.bag[i] = bag[i];
+    for (int i = 0; i < PREVIEW; ++i)
+        out.queue[i] = queue[i];
+}
+
+// Takes over a saved state; false (leaving this one unchanged) if any field is out of range
+bool Randomizer::restore(const State &in)
+{
+    if (in.mode > BAG || in.bagIndex > 7 || in.queueHead >= PREVIEW)
+        return false;
+    unsigned seen = 0; // The bag is shuffled in place, so it must hold every type exactly once
+    for (int i = 0; i < 7; ++i)
+        seen |= in.bag[i] < 7 ? 1u << in.bag[i] : 0;
+    if (seen != 0x7f)
+        return false;
+    for (int i = 0; i < PREVIEW; ++i)
+        if (in.queue[i] >= 7)
+            return false;
+
+    state = in.state;
+    mode = static_cast<Mode>(in.mode);
+    bagIndex = in.bagIndex;
+    queueHead = in.queueHead;
+    for (int i = 0; i < 7; ++i)
+        bag[i] = in.bag[i];
+    for (int i = 0; i < PREVIEW; ++i)
+        queue[i] = in.queue[i];
+    return true;
+}
+
+// SplitMix64 step (Steele, Lea and Flood)
+uint64_t Randomizer::nextRandom()
+{
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Lemire's multiply-and-reject reduction: exact uniformity without a division in the common case
+uint32_t Randomizer::below(uint32_t bound)
+{
+    uint64_t product = static_cast<uint64_t>(static_cast<uint32_t>(nextRandom() >> 32)) * bound;
+    uint32_t low = static_cast<uint32_t>(product);
+    if (low < bound)
+    {
+        uint32_t threshold = (0u - bound) % bound;
+        while (low < threshold)
+        {
+            product = static_cast<uint64_t>(static_cast<uint32_t>(nextRandom() >> 32)) * bound;
+            low = static_cast<uint32_t>(product);
+        }
+    }
+    return static_cast<uint32_t>(product >> 32);
+}
+
+// Draw one piece according to the mode
+Tetromino::Type Randomizer::generate()
+{
+    if (mode == UNIFORM)
+        return static_cast<Tetromino::Type>(below(7));
+
+    if (bagIndex == 7)
+    { // Fisher-Yates shuffle of a fresh bag
+        for (int i = 6; i > 0; --i)
+        {
+            int j = static_cast<int>(below(static_cast<uint32_t>(i + 1)));
+            uint8_t swap = bag[i];
+            bag[i] = bag[j];
+            bag[j] = swap;
+        }
+        bagIndex = 0;
+    }
+    return static_cast<Tetromino::Type>(bag[bagIndex++]);
+}
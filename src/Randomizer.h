@@ -0,0 +1,58 @@
+#ifndef RANDOMIZER_H
+#define RANDOMIZER_H
+
+#include "Tetromino.h"
+#include <cstdint>
+
+// Randomizer produces the piece sequence of one game. It is owned by the game, seeded explicitly,
+// and built on a fixed integer generator (SplitMix64) with unbiased range reduction, so the same
+// seed gives the same pieces on every platform and compiler.
+class Randomizer
+{
+public:
+    // How pieces are drawn
+    enum Mode
+    {
+        UNIFORM, // Every piece independently with probability 1/7
+        BAG      // Standard 7-bag: each group of 7 pieces is a shuffled set of all seven types
+    };
+
+    static const int PREVIEW = 6; // Upcoming pieces kept ready in the queue
+
+    // Complete generator state with a fixed layout (no padding), for checkpoints
+    struct State
+    {
+        uint64_t state;         // SplitMix64 state
+        uint8_t mode;           // Mode
+        uint8_t bagIndex;       // Next unused entry in bag
+        uint8_t queueHead;      // Index of the next piece in queue
+        uint8_t bag[7];         // Current bag, a permutation of the seven types
+        uint8_t queue[PREVIEW]; // Ring buffer of upcoming pieces
+    };
+
+    explicit Randomizer(uint64_t seed = 0, Mode mode = UNIFORM); // Constructor - seeds and fills the queue
+
+    void reset(uint64_t seed, Mode mode); // Restarts the sequence
+
+    Tetromino::Type next();                // Takes the next piece off the queue
+    Tetromino::Type peek(int index) const; // Upcoming piece (0 = the one next() returns), index < PREVIEW
+
+    Mode getMode() const { return mode; }
+
+    void save(State &out) const;   // Copies out the state; restoring it continues the same sequence
+    bool restore(const State &in); // Takes over a saved state; false (and unchanged) if it is not valid
+
+private:
+    uint64_t state;         // SplitMix64 state
+    Mode mode;              // Active drawing mode
+    uint8_t bag[7];         // Current bag (BAG mode)
+    int bagIndex;           // Next unused entry in bag
+    uint8_t queue[PREVIEW]; // Ring buffer of upcoming pieces
+    int queueHead;          // Index of the next piece in queue
+
+    uint64_t nextRandom();          // Next 64-bit value of the generator
+    uint32_t below(uint32_t bound); // Uniform value in [0, bound) without modulo bias
+    Tetromino::Type generate();     // Draws one piece according to the mode
+};
+
+#endif
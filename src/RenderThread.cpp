@@ -0,0 +1,95 @@
+#include "RenderThread.h"
+#include "Profiler.h"
+
+// Constructor - the thread starts with start()
+RenderThread::RenderThread(Renderer &renderer) : renderer(renderer), stopping(false), publishedFrame(-1)
+{
+}
+
+// Destructor - draws the last snapshot and joins the thread
+RenderThread::~RenderThread()
+{
+    stop();
+}
+
+// Starts the thread (does nothing if it is already running)
+void RenderThread::start()
+{
+    if (thread.joinable())
+        return;
+    last = GameClock::Clock::time_point(); // The gap while stopped is not a frame interval
+    stopping.store(false, std::memory_order_relaxed);
+    thread = std::thread(&RenderThread::run, this);
+}
+
+// Wakes the thread under the lock, so the request cannot be missed, and waits for it to finish
+void RenderThread::stop()
+{
+    if (!thread.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex); // Here the wake-up must not be lost
+        stopping.store(true, std::memory_order_release);
+    }
+    wake.notify_one();
+    thread.join();
+}
+
+// Starts the statistics of a new game
+void RenderThread::resetStats()
+{
+    stats = Stats();
+    publishedFrame = -1;
+}
+
+// The snapshot becomes the newest one; if the previous one was still waiting it is never drawn.
+// Only published snapshots are counted: the game publishes when something visible changed, so
+// idle frames between two snapshots were never meant to be drawn.
+void RenderThread::publish()
+{
+    long engineFrame = buffer.draft().engineFrame;
+    stats.published++;
+    if (buffer.publish())
+    {
+        stats.dropped++;
+        if (publishedFrame != engineFrame)
+            stats.unrenderedFrames++; // The replaced snapshot showed a frame of its own
+    }
+    publishedFrame = engineFrame;
+    wake.notify_one();
+}
+
+// Draws whatever is newest until stopped. stopping is read before take(), so a snapshot published
+// before stop() is always drawn before the thread exits.
+void RenderThread::run()
+{
+    while (true)
+    {
+        bool finished = stopping.load(std::memory_order_acquire);
+        if (buffer.take())
+            draw(buffer.latest());
+        else if (finished)
+            break;
+        else
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait_for(lock, std::chrono::milliseconds(WAKE_MS),
+                          [this] { return buffer.hasFresh() || stopping.load(std::memory_order_acquire); });
+        }
+    }
+}
+
+// Draws one snapshot and times it
+void RenderThread::draw(const Frame &frame)
+{
+    PROFILE_SCOPE(RENDER);
+    GameClock::Clock::time_point began = GameClock::Clock::now();
+    renderer.render(frame);
+    GameClock::Clock::time_point ended = GameClock::Clock::now();
+
+    if (last != GameClock::Clock::time_point())
+        stats.frameIntervals.add(std::chrono::duration<double, std::milli>(began - last).count());
+    stats.renderTimes.add(std::chrono::duration<double, std::milli>(ended - began).count());
+    last = began;
+    stats.drawn++;
+}
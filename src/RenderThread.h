@@ -0,0 +1,68 @@
+#ifndef RENDER_THREAD_H
+#define RENDER_THREAD_H
+
+#include "GameClock.h"
+#include "Renderer.h"
+#include "TripleBuffer.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// RenderThread draws frames on a thread of its own, so terminal output never holds up the
+// simulation. The game fills a Frame snapshot and publishes it through a TripleBuffer; the render
+// thread always draws the newest complete snapshot and skips any that were replaced before it got
+// to them. Publishing never blocks: the wake-up is a notify without the lock, and a wake-up lost
+// to that race only delays the frame until the next WAKE_MS poll.
+//
+// The Renderer is only touched by the thread between start() and stop(), so the owner may use it
+// directly (finish(), byte counts) while the thread is stopped.
+class RenderThread
+{
+public:
+    struct Stats
+    {
+        long published = 0;                      // Snapshots handed over by the simulation
+        long dropped = 0;                        // ... replaced by a newer one before the renderer took them
+        long drawn = 0;                          // Snapshots drawn
+        long unrenderedFrames = 0;               // Engine frames that changed the screen but were never drawn
+        GameClock::IntervalStats frameIntervals; // Time between drawn frames
+        GameClock::IntervalStats renderTimes;    // Time spent drawing each frame
+
+        double dropRate() const { return published > 0 ? static_cast<double>(dropped) / published : 0; }
+    };
+
+    static const int WAKE_MS = 5; // Longest the thread sleeps without checking for a snapshot
+
+    explicit RenderThread(Renderer &renderer); // The renderer must outlive this object
+    ~RenderThread();                           // Stops the thread
+
+    RenderThread(const RenderThread &) = delete;
+    RenderThread &operator=(const RenderThread &) = delete;
+
+    void start();      // Starts drawing published snapshots
+    void stop();       // Draws the newest snapshot, if not drawn yet, and joins the thread
+    void resetStats(); // Clears the statistics (only while stopped)
+
+    Frame &frame() { return buffer.draft(); } // Snapshot the simulation fills next
+    void publish();                           // Hands that snapshot to the renderer; never waits
+
+    const Stats &getStats() const { return stats; } // Only consistent while stopped
+
+private:
+    Renderer &renderer;
+    TripleBuffer<Frame> buffer;
+    std::thread thread;
+    std::mutex mutex; // Only for sleeping on wake
+    std::condition_variable wake;
+    std::atomic<bool> stopping;
+
+    Stats stats;                       // published, dropped and unrenderedFrames are written by the simulation, the rest by the thread
+    long publishedFrame;               // Engine frame of the last snapshot published (-1 = none yet)
+    GameClock::Clock::time_point last; // When the previous frame was drawn (epoch = none since start())
+
+    void run();                     // Thread body
+    void draw(const Frame &frame); // Draws one snapshot and updates the statistics
+};
+
+#endif
@@ -0,0 +1,254 @@
+#include "Renderer.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+// Constructor - nothing is on screen yet, so the first frame is a full redraw
+Renderer::Renderer() : length(0), fullRedraw(true), cursorHidden(false), activeColor(nullptr),
+                       lastFrameBytes(0), totalBytes(0), frameCount(0)
+{
+#if defined(_WIN32) && defined(ENABLE_VIRTUAL_TERMINAL_PROCESSING)
+    // Let the Windows console interpret the cursor movement escapes
+    HANDLE out = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD mode = 0;
+    if (GetConsoleMode(out, &mode))
+    {
+        SetConsoleMode(out, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+    }
+#endif
+}
+
+// Destructor - leave the terminal usable
+Renderer::~Renderer()
+{
+    if (cursorHidden)
+    {
+        finish();
+    }
+}
+
+// Draws a frame, sending only the cells that differ from what is already on screen
+void Renderer::render(const Frame &frame)
+{
+    compose(frame);
+
+    length = 0;
+    if (fullRedraw)
+    {
+        append("\033[2J"); // Clear the screen once instead of repainting blanks
+        activeColor = nullptr;
+    }
+    if (!cursorHidden)
+    {
+        append("\033[?25l"); // Hide the cursor while drawing
+        cursorHidden = true;
+    }
+
+    int cursorRow = -1;
+    int cursorCol = -1;
+    for (int row = 0; row < SCREEN_ROWS; ++row)
+    {
+        for (int col = 0; col < SCREEN_COLS; ++col)
+        {
+            const Cell &cell = screen[row][col];
+            if (fullRedraw)
+            {
+                if (cell.ch == ' ' && cell.color == Board::RESET_COLOR)
+                    continue; // Already blank after the clear
+            }
+            else if (cell.ch == previous[row][col].ch && cell.color == previous[row][col].color)
+            {
+                continue; // Unchanged
+            }
+
+            if (row != cursorRow || col != cursorCol)
+            {
+                if (row == cursorRow && col > cursorCol && canBridge(row, cursorCol, col))
+                {
+                    // Rewriting a few unchanged cells is cheaper than a cursor move
+                    for (int gap = cursorCol; gap < col; ++gap)
+                        buffer[length++] = screen[row][gap].ch;
+                }
+                else
+                {
+                    appendCursorMove(row, col);
+                }
+            }
+            if (cell.color != activeColor)
+            {
+                append(cell.color); // Only switch colors when the next cell needs a different one
+                activeColor = cell.color;
+            }
+            buffer[length++] = cell.ch;
+            cursorRow = row;
+            cursorCol = col + 1;
+        }
+    }
+
+    std::memcpy(previous, screen, sizeof(screen));
+    fullRedraw = false;
+
+    lastFrameBytes = length;
+    totalBytes += length;
+    frameCount++;
+    flush();
+}
+
+// Forces the next frame to repaint the whole screen
+void Renderer::invalidate()
+{
+    fullRedraw = true;
+    activeColor = nullptr;
+}
+
+// Parks the cursor under the frame with default colors so regular output can follow
+void Renderer::finish()
+{
+    length = 0;
+    appendCursorMove(SCREEN_ROWS, 0);
+    append(Board::RESET_COLOR);
+    append("\033[?25h"); // Show the cursor again
+    flush();
+
+    cursorHidden = false;
+    invalidate();
+}
+
+// Lays out the HUD, the bordered board and the status line
+void Renderer::compose(const Frame &frame)
+{
+    for (int row = 0; row < SCREEN_ROWS; ++row)
+    {
+        for (int col = 0; col < SCREEN_COLS; ++col)
+        {
+            screen[row][col].ch = ' ';
+            screen[row][col].color = Board::RESET_COLOR;
+        }
+    }
+
+    char hud[SCREEN_COLS + 1];
+    std::snprintf(hud, sizeof(hud), "Score: %d | Level: %d | High Score: %d | Next: %c",
+                  frame.score, frame.level, frame.highScore, frame.nextPiece);
+    putText(0, 0, hud, Board::RESET_COLOR);
+
+    // Each board cell is two characters wide so the board keeps a square look
+    const int boardTop = 1;
+    const int lastCol = 2 * Board::WIDTH + 1;
+    for (int col = 0; col <= lastCol; ++col)
+    {
+        char edge = (col == 0 || col == lastCol) ? '+' : '-';
+        screen[boardTop][col] = {edge, Board::COLOR_FRAME};
+        screen[boardTop + Board::HEIGHT + 1][col] = {edge, Board::COLOR_FRAME};
+    }
+    for (int y = 0; y < Board::HEIGHT; ++y)
+    {
+        Cell *line = screen[boardTop + 1 + y];
+        line[0] = {'|', Board::COLOR_FRAME};
+        line[lastCol] = {'|', Board::COLOR_FRAME};
+        for (int x = 0; x < Board::WIDTH; ++x)
+        {
+            char cell = frame.cells[y][x];
+            const char *color = Board::cellColor(cell);
+            if (cell == ' ')
+            {
+                line[1 + 2 * x] = {'.', color}; // Gray dots for empty cells
+                line[2 + 2 * x] = {' ', color};
+            }
+            else
+            {
+                line[1 + 2 * x] = {'#', color}; // Colored hashes for blocks
+                line[2 + 2 * x] = {'#', color};
+            }
+        }
+    }
+
+    if (frame.message[0] != '\0')
+    {
+        putText(SCREEN_ROWS - 1, 0, frame.message, Board::RESET_COLOR);
+    }
+
+    // Overlay lines start next to the top of the board
+    int row = boardTop + 1;
+    for (const char *line = frame.overlay; *line != '\0' && row < SCREEN_ROWS - 1; ++row)
+    {
+        const char *end = std::strchr(line, '\n');
+        char text[SCREEN_COLS + 1];
+        size_t length = end != nullptr ? static_cast<size_t>(end - line) : std::strlen(line);
+        if (length > sizeof(text) - 1)
+            length = sizeof(text) - 1;
+        std::memcpy(text, line, length);
+        text[length] = '\0';
+        putText(row, lastCol + 3, text, Board::RESET_COLOR);
+        line = end != nullptr ? end + 1 : line + std::strlen(line);
+    }
+}
+
+// Checks whether cells [from, to) of a row can be re-sent in the active color instead of moving the cursor
+bool Renderer::canBridge(int row, int from, int to) const
+{
+    if (to - from > MAX_BRIDGE)
+        return false;
+    for (int col = from; col < to; ++col)
+    {
+        const Cell &cell = screen[row][col];
+        if (cell.ch != ' ' && cell.color != activeColor)
+            return false; // Would be drawn in the wrong color (blanks look the same in any color)
+    }
+    return true;
+}
+
+// Writes text into the screen being composed, clipped to the screen width
+void Renderer::putText(int row, int col, const char *text, const char *color)
+{
+    for (; *text != '\0' && col < SCREEN_COLS; ++text, ++col)
+    {
+        screen[row][col] = {*text, color};
+    }
+}
+
+// Appends a string to the output buffer
+void Renderer::append(const char *text)
+{
+    size_t n = std::strlen(text);
+    std::memcpy(buffer + length, text, n);
+    length += n;
+}
+
+// Appends an escape sequence moving the cursor to a 0-based screen position
+void Renderer::appendCursorMove(int row, int col)
+{
+    length += std::snprintf(buffer + length, BUFFER_SIZE - length, "\033[%d;%dH", row + 1, col + 1);
+}
+
+// Sends the whole buffer to the terminal in one write
+void Renderer::flush()
+{
+    std::cout.flush(); // Anything printed through iostreams must come first
+
+#ifdef _WIN32
+    std::fwrite(buffer, 1, length, stdout);
+    std::fflush(stdout);
+#else
+    const char *data = buffer;
+    size_t remaining = length;
+    while (remaining > 0)
+    {
+        ssize_t written = write(STDOUT_FILENO, data, remaining);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break; // Terminal went away; nothing sensible left to do
+        }
+        data += written;
+        remaining -= written;
+    }
+#endif
+}
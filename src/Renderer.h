@@ -0,0 +1,72 @@
+#ifndef RENDERER_H
+#define RENDERER_H
+
+#include "Board.h"
+#include <cstddef>
+
+// Everything the renderer needs to draw one frame. A frame owns all of its text, so it is a
+// self-contained snapshot that can be handed to another thread.
+struct Frame
+{
+    char cells[Board::HEIGHT][Board::WIDTH]; // Board contents with the falling piece overlaid
+    int score;                               // Current score
+    int level;                               // Current level
+    int highScore;                           // Highest score of the session
+    char nextPiece;                          // Character of the upcoming piece
+    long engineFrame;                        // Engine frame the snapshot was taken at
+    char message[96];                        // Status line under the board ("" for none)
+    char overlay[512];                       // Lines drawn to the right of the board, separated by '\n' ("" for none)
+};
+
+// Renderer draws frames to the terminal, sending only the cells that changed since the previous frame
+class Renderer
+{
+public:
+    static const int SCREEN_ROWS = Board::HEIGHT + 4; // HUD, top border, board rows, bottom border, message
+    static const int SCREEN_COLS = 80;                // Wide enough for the HUD line
+
+    Renderer();  // Constructor - the first frame is a full redraw
+    ~Renderer(); // Restores the cursor and colors
+
+    void render(const Frame &frame); // Draws a frame with a single write
+    void invalidate();               // Forces a full redraw on the next frame (after other output)
+    void finish();                   // Moves the cursor below the frame so normal output can follow
+
+    size_t getLastFrameBytes() const { return lastFrameBytes; } // Bytes written for the most recent frame
+    size_t getTotalBytes() const { return totalBytes; }         // Bytes written since construction
+    long getFrameCount() const { return frameCount; }           // Frames rendered since construction
+
+private:
+    // One character on screen and the color escape it is drawn with
+    struct Cell
+    {
+        char ch;
+        const char *color;
+    };
+
+    // Worst case per cell: cursor move, color escape and the character itself
+    static const size_t BUFFER_SIZE = SCREEN_ROWS * SCREEN_COLS * 24 + 64;
+    static const int MAX_BRIDGE = 6; // Longest run of unchanged cells re-sent instead of a cursor move
+
+    Cell screen[SCREEN_ROWS][SCREEN_COLS];   // Frame being composed
+    Cell previous[SCREEN_ROWS][SCREEN_COLS]; // Frame currently on the terminal
+    char buffer[BUFFER_SIZE];                // Output for one frame
+    size_t length;                           // Bytes used in buffer
+    bool fullRedraw;                         // Repaint everything on the next frame
+    bool cursorHidden;                       // Whether the terminal cursor is currently hidden
+
+    const char *activeColor;                 // Color the terminal is currently set to (nullptr if unknown)
+
+    size_t lastFrameBytes; // Bytes written for the most recent frame
+    size_t totalBytes;     // Bytes written since construction
+    long frameCount;       // Frames rendered since construction
+
+    void compose(const Frame &frame);                                    // Lays the frame out into screen
+    void putText(int row, int col, const char *text, const char *color); // Writes text into screen
+    bool canBridge(int row, int from, int to) const;                     // Whether a gap can be re-sent as is
+    void append(const char *text);                                       // Appends a string to buffer
+    void appendCursorMove(int row, int col);                             // Appends an absolute cursor move
+    void flush();                                                        // Writes buffer to the terminal
+};
+
+#endif
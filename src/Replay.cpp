@@ -0,0 +1,161 @@
+#include "Replay.h"
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    const char HEADER_MAGIC[4] = {'T', 'R', 'P', 'L'};
+    const char FOOTER_MAGIC[4] = {'T', 'E', 'N', 'D'};
+    const uint16_t VERSION = 1;
+
+    // Appends an unsigned integer of the given width in little-endian order
+    void putLittleEndian(std::vector<uint8_t> &out, uint64_t value, int bytes)
+    {
+        for (int i = 0; i < bytes; ++i)
+            out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+
+    // Reads an unsigned little-endian integer of the given width
+    uint64_t getLittleEndian(const uint8_t *in, int bytes)
+    {
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; ++i)
+            value |= static_cast<uint64_t>(in[i]) << (8 * i);
+        return value;
+    }
+}
+
+// Constructor - empty recording
+ReplayWriter::ReplayWriter() : lastFrame(0), recordCount(0) {}
+
+// Start a new recording with the header
+void ReplayWriter::begin(unsigned seed, Randomizer::Mode mode)
+{
+    data.clear();
+    data.insert(data.end(), HEADER_MAGIC, HEADER_MAGIC + 4);
+    putLittleEndian(data, VERSION, 2);
+    putLittleEndian(data, static_cast<uint8_t>(mode), 1);
+    putLittleEndian(data, 0, 1);
+    putLittleEndian(data, seed, 4);
+    lastFrame = 0;
+    recordCount = 0;
+}
+
+// Log one input as (frame delta, actions)
+void ReplayWriter::record(long frame, unsigned actions)
+{
+    uint64_t delta = static_cast<uint64_t>(frame - lastFrame);
+    do
+    { // LEB128: 7 bits per byte, high bit set while more bytes follow
+        uint8_t byte = delta & 0x7F;
+        delta >>= 7;
+        data.push_back(static_cast<uint8_t>(delta != 0 ? byte | 0x80 : byte));
+    } while (delta != 0);
+    data.push_back(static_cast<uint8_t>(actions));
+
+    lastFrame = frame;
+    recordCount++;
+}
+
+// Append the footer and write everything in one go
+bool ReplayWriter::finish(const Engine &engine, const char *path)
+{
+    std::vector<uint8_t> out = data;
+    putLittleEndian(out, recordCount, 4);
+    putLittleEndian(out, static_cast<uint32_t>(engine.getFrame()), 4);
+    putLittleEndian(out, static_cast<uint32_t>(engine.getScore()), 4);
+    putLittleEndian(out, static_cast<uint32_t>(engine.getLinesCleared()), 4);
+    putLittleEndian(out, engine.getBoard().checksum(), 8);
+    out.insert(out.end(), FOOTER_MAGIC, FOOTER_MAGIC + 4);
+
+    FILE *file = std::fopen(path, "wb");
+    if (file == nullptr)
+        return false;
+    bool written = std::fwrite(out.data(), 1, out.size(), file) == out.size();
+    return std::fclose(file) == 0 && written;
+}
+
+// Map the replay file
+bool ReplayPlayer::open(const char *path)
+{
+    return file.open(path);
+}
+
+// Re-run the recorded inputs at full speed and compare with the footer
+ReplayCheck ReplayPlayer::verify() const
+{
+    ReplayCheck check = {false, nullptr, 0, 0, 0};
+    const uint8_t *bytes = file.data();
+    size_t size = file.size();
+
+    if (size < HEADER_SIZE + FOOTER_SIZE || std::memcmp(bytes, HEADER_MAGIC, 4) != 0 ||
+        std::memcmp(bytes + size - 4, FOOTER_MAGIC, 4) != 0)
+    {
+        check.error = "not a replay file";
+        return check;
+    }
+    if (getLittleEndian(bytes + 4, 2) != VERSION)
+    {
+        check.error = "unsupported replay version";
+        return check;
+    }
+    if (bytes[6] > Randomizer::BAG)
+    {
+        check.error = "not a replay file (unknown randomizer)";
+        return check;
+    }
+
+    Randomizer::Mode mode = static_cast<Randomizer::Mode>(bytes[6]);
+    unsigned seed = static_cast<unsigned>(getLittleEndian(bytes + 8, 4));
+    const uint8_t *footer = bytes + size - FOOTER_SIZE;
+    uint32_t recordCount = static_cast<uint32_t>(getLittleEndian(footer, 4));
+    long frames = static_cast<long>(getLittleEndian(footer + 4, 4));
+    int score = static_cast<int>(getLittleEndian(footer + 8, 4));
+    int lines = static_cast<int>(getLittleEndian(footer + 12, 4));
+    uint64_t boardChecksum = getLittleEndian(footer + 16, 8);
+
+    Engine engine(seed, mode);
+    const uint8_t *cursor = bytes + HEADER_SIZE;
+    long frame = 0;
+    for (uint32_t i = 0; i < recordCount; ++i)
+    {
+        uint64_t delta = 0;
+        int shift = 0;
+        do
+        {
+            if (cursor >= footer || shift > 56)
+            {
+                check.error = "truncated records";
+                return check;
+            }
+            delta |= static_cast<uint64_t>(*cursor & 0x7F) << shift;
+            shift += 7;
+        } while (*cursor++ & 0x80);
+        if (cursor >= footer)
+        {
+            check.error = "truncated records";
+            return check;
+        }
+        unsigned actions = *cursor++;
+
+        frame += static_cast<long>(delta);
+        while (engine.getFrame() < frame && !engine.isGameOver())
+            engine.tick();
+        engine.input(actions);
+    }
+    while (engine.getFrame() < frames && !engine.isGameOver())
+        engine.tick();
+
+    check.score = engine.getScore();
+    check.lines = engine.getLinesCleared();
+    check.frames = engine.getFrame();
+    if (check.frames != frames)
+        check.error = "frame count differs";
+    else if (check.score != score || check.lines != lines)
+        check.error = "score differs";
+    else if (engine.getBoard().checksum() != boardChecksum)
+        check.error = "board differs";
+    else
+        check.ok = true;
+    return check;
+}
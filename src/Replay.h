@@ -0,0 +1,55 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "Engine.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <vector>
+
+// Binary replay file (all integers little-endian):
+//   header  "TRPL", version (u16), randomizer mode (u8), reserved (u8), seed (u32)
+//   records frame delta since the previous record (LEB128 varint), Engine::Action bitmask (u8)
+//   footer  record count (u32), frames (u32), score (i32), lines (i32), board checksum (u64), "TEND"
+// A record means "apply these actions before tick number <frame>"; frames without input are not stored.
+
+// ReplayWriter collects the inputs of one game and writes them out when the game ends
+class ReplayWriter
+{
+public:
+    ReplayWriter();
+
+    void begin(unsigned seed, Randomizer::Mode mode);    // Starts a new recording
+    void record(long frame, unsigned actions);           // Logs the actions applied before the given tick
+    bool finish(const Engine &engine, const char *path); // Writes the file with the final state as footer
+
+private:
+    std::vector<uint8_t> data; // Header and records so far
+    long lastFrame;            // Frame of the previous record (for delta encoding)
+    uint32_t recordCount;      // Records written so far
+};
+
+// Result of re-running a replay
+struct ReplayCheck
+{
+    bool ok;           // Replay matched its footer
+    const char *error; // Reason for failure (nullptr when ok)
+    int score;         // Score reached on playback
+    int lines;         // Lines cleared on playback
+    long frames;       // Frames simulated on playback
+};
+
+// ReplayPlayer memory-maps a replay and re-runs it through the Engine with no rendering or sleeping
+class ReplayPlayer
+{
+public:
+    bool open(const char *path); // Maps the replay file
+    ReplayCheck verify() const;  // Replays every input and compares score, lines and board checksum
+
+private:
+    static const size_t HEADER_SIZE = 12;
+    static const size_t FOOTER_SIZE = 28;
+
+    MappedFile file; // Mapped replay contents
+};
+
+#endif
@@ -0,0 +1,406 @@
+#include "ScoreStore.h"
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const uint32_t MAGIC = 0x4f435354; // "TSCO"
+    const uint16_t VERSION = 1;
+
+    struct FileHeader
+    {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t recordSize;        // sizeof(StoredRecord), so a file from a different layout is rejected
+        uint64_t folded;            // Records folded into summary = sequence of the first record after the header
+        ScoreStore::Summary summary;
+        uint32_t reserved;
+        uint32_t checksum;          // Of every byte before it
+    };
+
+    struct StoredRecord
+    {
+        uint64_t sequence;          // Position in the lifetime of the store, so a stale record never fits
+        ScoreStore::GameRecord game;
+        uint32_t reserved;
+        uint32_t checksum;          // Of every byte before it
+    };
+
+    // Both are written and read as raw bytes, so neither may contain implicit padding
+    static_assert(sizeof(FileHeader) == 16 + sizeof(ScoreStore::Summary) + 8, "the header layout has padding");
+    static_assert(sizeof(StoredRecord) == 8 + sizeof(ScoreStore::GameRecord) + 8, "the record layout has padding");
+
+    // FNV-1a over the bytes before the checksum field
+    template <typename T>
+    uint32_t checksumOf(const T &value)
+    {
+        const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&value);
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < offsetof(T, checksum); ++i)
+            hash = (hash ^ bytes[i]) * 16777619u;
+        return hash;
+    }
+}
+
+// Folds one game into the totals
+void ScoreStore::Summary::add(const GameRecord &game)
+{
+    games++;
+    totalScore += static_cast<uint64_t>(game.score);
+    totalLines += static_cast<uint64_t>(game.lines);
+    totalFrames += game.frames;
+    for (int type = 0; type < 7; ++type)
+        pieces[type] += game.pieces[type];
+    scoreHistogram[scoreBucket(game.score)]++;
+    if (games == 1 || game.score > highScore)
+    {
+        highScore = game.score;
+        highScoreLevel = game.level;
+        highScoreAt = game.endedAt;
+    }
+}
+
+// Constructor - nothing is read until open()
+ScoreStore::ScoreStore() : fd(-1), lockFd(-1), nextSequence(0), tailRecords(0), fileSize(0), summary(), compactions(0)
+{
+}
+
+// Destructor - releases the file and its lock
+ScoreStore::~ScoreStore()
+{
+    close();
+}
+
+// The final state of a game as a record
+ScoreStore::GameRecord ScoreStore::recordOf(const Engine &engine, int64_t endedAt)
+{
+    GameRecord game = {};
+    game.score = engine.getScore();
+    game.lines = engine.getLinesCleared();
+    game.level = engine.getLevel();
+    game.frames = static_cast<uint32_t>(engine.getFrame());
+    game.endedAt = endedAt;
+    for (int type = 0; type < 7; ++type)
+        game.pieces[type] = static_cast<uint32_t>(engine.getPiecesOfType(static_cast<Tetromino::Type>(type)));
+    return game;
+}
+
+// Bucket 0 holds scores below 100; bucket b >= 1 starts at 100 * 2^(b - 1), and the last one is open-ended
+int ScoreStore::scoreBucket(int score)
+{
+    int bucket = 0;
+    while (bucket + 1 < SCORE_BUCKETS && score >= bucketLow(bucket + 1))
+        bucket++;
+    return bucket;
+}
+
+// Inverse of scoreBucket: the lowest score that lands in bucket
+int ScoreStore::bucketLow(int bucket)
+{
+    return bucket == 0 ? 0 : Engine::POINTS_PER_LINE << (bucket - 1);
+}
+
+// Games, high score, totals and the score histogram, as printed by --stats
+void ScoreStore::printSummary(std::ostream &out) const
+{
+    out << "Games played:  " << summary.games << " (mean score " << summary.meanScore() << ")\n";
+    if (summary.games == 0)
+        return;
+
+    char when[64] = "";
+    time_t at = static_cast<time_t>(summary.highScoreAt);
+    if (const std::tm *local = std::localtime(&at))
+        std::strftime(when, sizeof(when), "%Y-%m-%d %H:%M", local);
+    out << "High score:    " << summary.highScore << " (level " << summary.highScoreLevel << ", " << when << ")\n"
+        << "Lines cleared: " << summary.totalLines << ", frames played: " << summary.totalFrames << "\n"
+        << "Pieces:       ";
+    for (int type = 0; type < 7; ++type)
+        out << " " << Tetromino::typeChar(static_cast<Tetromino::Type>(type)) << " " << summary.pieces[type];
+    out << "\nScore distribution:\n";
+    for (int bucket = 0; bucket < SCORE_BUCKETS; ++bucket)
+    {
+        if (summary.scoreHistogram[bucket] == 0)
+            continue;
+        char range[48];
+        char line[96];
+        if (bucket + 1 < SCORE_BUCKETS)
+            std::snprintf(range, sizeof(range), "%d-%d", bucketLow(bucket), bucketLow(bucket + 1) - 1);
+        else
+            std::snprintf(range, sizeof(range), "%d+", bucketLow(bucket));
+        std::snprintf(line, sizeof(line), "  %-16s %llu\n", range, static_cast<unsigned long long>(summary.scoreHistogram[bucket]));
+        out << line;
+    }
+}
+
+#ifndef _WIN32
+
+namespace
+{
+    bool writeAll(int fd, const void *data, size_t size)
+    {
+        const char *bytes = static_cast<const char *>(data);
+        while (size > 0)
+        {
+            ssize_t written = write(fd, bytes, size);
+            if (written < 0 && errno == EINTR)
+                continue;
+            if (written <= 0)
+                return false;
+            bytes += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    // Takes the lock that keeps a second game from writing to the store. It lives in a file of its
+    // own, because compaction replaces the data file and a lock on that would go with it.
+    int lockStore(const std::string &path)
+    {
+        std::string lockPath = path + ".lock";
+        int fd = ::open(lockPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd >= 0 && flock(fd, LOCK_EX | LOCK_NB) != 0)
+        {
+            ::close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    int openForAppend(const std::string &path)
+    {
+        return ::open(path.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+    }
+
+    // Makes a rename in the directory of path durable
+    void syncDirectory(const std::string &path)
+    {
+        size_t slash = path.rfind('/');
+        std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+        int fd = ::open(directory.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return;
+        fsync(fd);
+        ::close(fd);
+    }
+}
+
+// Takes the lock, then rebuilds the summary from the header plus the records after it. A torn or
+// damaged tail is truncated, and a tail that has reached COMPACT_RECORDS is folded in at once.
+bool ScoreStore::open(const char *storePath)
+{
+    close();
+    path = storePath;
+    summary = Summary();
+    openStats = OpenStats();
+    compactions = 0;
+    nextSequence = 0;
+
+    // Locked before anything is read, so the file cannot change between reading and appending
+    lockFd = lockStore(path);
+    if (lockFd < 0)
+    {
+        std::cerr << "The score file " << path << " is in use by another game\n";
+        return false;
+    }
+
+    struct stat info;
+    if (stat(storePath, &info) != 0 && errno == ENOENT)
+    {
+        if (!writeHeader(0))
+        {
+            std::cerr << "Cannot create the score file " << path << "\n";
+            close();
+            return false;
+        }
+        openStats.created = true;
+        fileSize = sizeof(FileHeader);
+    }
+    else
+    {
+        // Only the header and the records since the last compaction are read
+        MappedFile file;
+        FileHeader header;
+        if (!file.open(storePath) || file.size() < sizeof(header))
+        {
+            std::cerr << "Cannot read the score file " << path << "\n";
+            close();
+            return false;
+        }
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (header.magic != MAGIC || header.version != VERSION || header.recordSize != sizeof(StoredRecord) ||
+            header.checksum != checksumOf(header))
+        {
+            std::cerr << path << " is not a score file of this version\n";
+            close();
+            return false;
+        }
+        summary = header.summary;
+        nextSequence = header.folded;
+
+        size_t offset = sizeof(header);
+        for (; offset + sizeof(StoredRecord) <= file.size(); offset += sizeof(StoredRecord))
+        {
+            StoredRecord record;
+            std::memcpy(&record, file.data() + offset, sizeof(record));
+            if (record.checksum != checksumOf(record) || record.sequence != nextSequence)
+                break; // Torn by a crash (or damaged); nothing after it can be trusted
+            summary.add(record.game);
+            nextSequence++;
+            openStats.replayed++;
+        }
+        fileSize = offset;
+        if (offset < file.size())
+        {
+            openStats.recovered = true;
+            openStats.droppedBytes = static_cast<long>(file.size() - offset);
+        }
+    }
+
+    fd = openForAppend(path);
+    if (fd < 0)
+    {
+        std::cerr << "Cannot open the score file " << path << "\n";
+        close();
+        return false;
+    }
+    if (openStats.recovered && (ftruncate(fd, static_cast<off_t>(fileSize)) != 0 || fsync(fd) != 0))
+    {
+        std::cerr << "Cannot repair the score file " << path << "\n";
+        close();
+        return false;
+    }
+    tailRecords = openStats.replayed;
+    if (tailRecords >= COMPACT_RECORDS)
+        compact();
+    return true;
+}
+
+// Closes the data file and releases the lock; the summary stays readable
+void ScoreStore::close()
+{
+    if (fd >= 0)
+        ::close(fd);
+    if (lockFd >= 0)
+        ::close(lockFd); // Releases the lock
+    fd = -1;
+    lockFd = -1;
+}
+
+// Writes the record with the next sequence number in one write() and fsyncs it before the summary
+// counts it; a failed write is cut off so the file still ends on a record boundary
+bool ScoreStore::append(const GameRecord &game)
+{
+    if (fd < 0)
+        return false;
+
+    StoredRecord record = {};
+    record.sequence = nextSequence;
+    record.game = game;
+    record.checksum = checksumOf(record);
+    if (!writeAll(fd, &record, sizeof(record)) || fsync(fd) != 0)
+    {
+        // Cut off whatever part was written, so the next record starts on a record boundary
+        if (ftruncate(fd, static_cast<off_t>(fileSize)) != 0)
+            std::cerr << "Cannot repair the score file " << path << "\n";
+        return false;
+    }
+    fileSize += sizeof(record);
+    nextSequence++;
+    tailRecords++;
+    summary.add(game);
+
+    if (tailRecords >= COMPACT_RECORDS)
+        compact();
+    return true;
+}
+
+// The old file stays in place until the new one is complete and synced, so a crash at any point
+// leaves one or the other
+bool ScoreStore::compact()
+{
+    if (fd < 0 || !writeHeader(nextSequence))
+        return false;
+    ::close(fd); // Still the old file, which the rename has unlinked; the lock is not on it
+    fd = openForAppend(path);
+    if (fd < 0)
+    {
+        std::cerr << "Cannot reopen the score file " << path << "\n";
+        close();
+        return false;
+    }
+    tailRecords = 0;
+    fileSize = sizeof(FileHeader);
+    compactions++;
+    return true;
+}
+
+// Writes a header over the current summary to path + ".tmp", syncs it and renames it over the store
+bool ScoreStore::writeHeader(uint64_t folded)
+{
+    FileHeader header = {};
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.recordSize = sizeof(StoredRecord);
+    header.folded = folded;
+    header.summary = summary;
+    header.checksum = checksumOf(header);
+
+    std::string temporary = path + ".tmp";
+    int out = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (out < 0)
+        return false;
+    bool ok = writeAll(out, &header, sizeof(header)) && fsync(out) == 0;
+    ::close(out);
+    if (!ok || rename(temporary.c_str(), path.c_str()) != 0)
+    {
+        unlink(temporary.c_str());
+        return false;
+    }
+    syncDirectory(path);
+    return true;
+}
+
+#else
+
+// Reports that scores are not kept without POSIX file I/O
+bool ScoreStore::open(const char *)
+{
+    std::cerr << "Keeping scores needs POSIX file I/O (Linux/macOS)\n";
+    return false;
+}
+
+// Nothing to close: open() never succeeds here
+void ScoreStore::close()
+{
+}
+
+// Never open, so nothing is recorded
+bool ScoreStore::append(const GameRecord &)
+{
+    return false;
+}
+
+// Never open, so there is nothing to fold
+bool ScoreStore::compact()
+{
+    return false;
+}
+
+// Never called without POSIX file I/O
+bool ScoreStore::writeHeader(uint64_t)
+{
+    return false;
+}
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef SCORE_STORE_H
+#define SCORE_STORE_H
+
+#include "Engine.h"
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+// Score file (fixed-size structs in native byte order):
+//   header  "TSCO", version (u16), record size (u16), records folded (u64), Summary, checksum (u32)
+//   records one GameRecord per finished game, each with its sequence number and its own checksum
+//
+// ScoreStore keeps the high score and lifetime statistics across sessions. A finished game is
+// appended as one record with a single write() followed by fsync(), so a crash loses at most the
+// game being written. Opening maps the file and starts from the summary in its header, then
+// replays only the records appended since the last compaction; that tail is never longer than
+// COMPACT_RECORDS, so opening costs the same however many games the file has seen. A final record
+// that fails its checksum (torn by a crash mid-write) is cut off. Every COMPACT_RECORDS games the
+// summary is folded into a new header, written to a temporary file and renamed over the old one.
+//
+// Queries are answered from the in-memory Summary, which every append updates. The store is locked
+// (flock on path + ".lock") while open, so a second game started on the same file keeps its scores
+// to itself.
+// Linux/macOS only; on Windows open() reports that scores are not kept.
+class ScoreStore
+{
+public:
+    static const int COMPACT_RECORDS = 64; // Records appended before they are folded into the header
+    static const int SCORE_BUCKETS = 16;   // Score histogram buckets (see scoreBucket)
+
+    // What one finished game contributes
+    struct GameRecord
+    {
+        int32_t score;
+        int32_t lines;
+        int32_t level;
+        uint32_t frames;    // Engine frames the game lasted
+        int64_t endedAt;    // Unix time the game ended
+        uint32_t pieces[7]; // Pieces locked, by Tetromino::Type
+        uint32_t reserved;
+    };
+
+    // Lifetime totals over every game in the store
+    struct Summary
+    {
+        uint64_t games;
+        uint64_t totalScore;
+        uint64_t totalLines;
+        uint64_t totalFrames;
+        uint64_t pieces[7];                     // By Tetromino::Type
+        uint64_t scoreHistogram[SCORE_BUCKETS]; // Games per score bucket
+        int32_t highScore;
+        int32_t highScoreLevel;                 // Level the high score was reached on
+        int64_t highScoreAt;                    // Unix time of the high score game
+
+        void add(const GameRecord &game); // Folds one game in
+        double meanScore() const { return games > 0 ? static_cast<double>(totalScore) / games : 0; }
+    };
+
+    // What open() found
+    struct OpenStats
+    {
+        long replayed = 0;      // Records read after the header
+        bool recovered = false; // A torn or corrupt tail was cut off
+        long droppedBytes = 0;  // ... this many bytes of it
+        bool created = false;   // The file did not exist and was created empty
+    };
+
+    ScoreStore();
+    ~ScoreStore();
+
+    ScoreStore(const ScoreStore &) = delete;
+    ScoreStore &operator=(const ScoreStore &) = delete;
+
+    bool open(const char *path); // Opens or creates the store; false (with a message) if it cannot be used
+    void close();                // The summary stays readable
+    bool isOpen() const { return fd >= 0; }
+
+    bool append(const GameRecord &game); // Durably records a finished game (and compacts when due)
+    bool compact();                      // Folds every record into the header now
+
+    const Summary &getSummary() const { return summary; }
+    const OpenStats &getOpenStats() const { return openStats; }
+    long getCompactions() const { return compactions; }
+    void printSummary(std::ostream &out) const; // Lifetime statistics as a short report
+
+    static GameRecord recordOf(const Engine &engine, int64_t endedAt); // Record of a finished game
+    static int scoreBucket(int score);                                 // Histogram bucket: scores in [bucketLow(b), bucketLow(b + 1))
+    static int bucketLow(int bucket);                                  // Smallest score in a bucket
+
+private:
+    std::string path;
+    int fd;                // Open for appending (-1 = closed)
+    int lockFd;            // Holds the lock on path + ".lock" while open (-1 = none)
+    uint64_t nextSequence; // Sequence number of the next record
+    long tailRecords;      // Records after the header
+    uint64_t fileSize;     // Bytes in the file
+    Summary summary;
+    OpenStats openStats;
+    long compactions;
+
+    bool writeHeader(uint64_t folded); // Replaces the file with a header over the current summary and no records
+};
+
+#endif
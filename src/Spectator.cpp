@@ -0,0 +1,74 @@
+#include "Spectator.h"
+#include "InputHandler.h"
+#include "Renderer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+// Constructor - fps caps how often the viewer redraws
+Spectator::Spectator(int fps) : fps(fps > 0 ? fps : 1)
+{
+}
+
+// Attaches to the broadcast called name and draws it until the game ends or the viewer quits
+bool Spectator::run(const char *name)
+{
+    if (!reader.attach(name))
+    {
+        std::cerr << "No broadcast named " << name << "\n";
+        return false;
+    }
+
+    InputHandler inputHandler; // Raw mode for Q, restored on return
+    Protocol::Screen screen;
+    Protocol::clear(screen);
+    int highScore = 0;
+    {
+        Renderer renderer;
+        auto interval = std::chrono::microseconds(1000000 / fps);
+        auto nextFrame = std::chrono::steady_clock::now();
+        while (true)
+        {
+            bool live = reader.poll(screen);
+            if (reader.hasFrame())
+            {
+                Frame frame;
+                const BroadcastReader::Stats &stats = reader.getStats();
+                std::snprintf(frame.message, sizeof(frame.message), "Watching %s | lag %ld (max %ld), dropped %ld, skips %ld",
+                              name, stats.lag, stats.maxLag, stats.dropped, stats.skips);
+                highScore = screen.score > highScore ? screen.score : highScore;
+
+                std::copy(&screen.cells[0][0], &screen.cells[0][0] + sizeof(screen.cells), &frame.cells[0][0]);
+                frame.score = screen.score;
+                frame.level = screen.level;
+                frame.highScore = highScore;
+                frame.nextPiece = screen.next;
+                frame.engineFrame = 0; // Not carried by the broadcast
+                frame.overlay[0] = '\0';
+                renderer.render(frame);
+            }
+            if (!live)
+                break; // The game closed its broadcast
+
+            nextFrame += interval;
+            auto now = std::chrono::steady_clock::now();
+            if (nextFrame < now)
+                nextFrame = now; // Drawing took longer than a frame; do not try to catch up
+            int waitMs = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(nextFrame - now).count());
+            if (inputHandler.waitForInput(waitMs))
+            {
+                inputHandler.update();
+                if (inputHandler.quitPressed())
+                    break;
+            }
+        }
+        renderer.finish();
+    }
+
+    const BroadcastReader::Stats &stats = reader.getStats();
+    std::cout << "\nApplied " << stats.applied << " deltas; dropped " << stats.dropped << " in " << stats.skips
+              << " jumps to a keyframe; largest lag " << stats.maxLag << " deltas\n";
+    reader.detach();
+    return true;
+}
@@ -0,0 +1,22 @@
+#ifndef SPECTATOR_H
+#define SPECTATOR_H
+
+#include "Broadcast.h"
+
+// Spectator watches a broadcast game in the terminal. It wakes at its own frame rate, applies
+// every delta published since the last frame (or jumps to the latest keyframe when it has fallen
+// too far behind) and draws the result with the diff-based Renderer. Its lag and drop counters are
+// shown under the board. Q stops watching.
+class Spectator
+{
+public:
+    explicit Spectator(int fps); // Constructor - frames drawn per second
+
+    bool run(const char *name); // Watches until the broadcast ends or Q is pressed; false if it cannot attach
+
+private:
+    int fps;
+    BroadcastReader reader;
+};
+
+#endif
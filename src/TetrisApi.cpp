@@ -0,0 +1,220 @@
+#include "TetrisApi.h"
+#include "Engine.h"
+#include <new>
+#include <vector>
+
+// The C constants are plain numbers so C callers need no C++ headers; keep them in step with the rules
+static_assert(TETRIS_WIDTH == Board::WIDTH && TETRIS_HEIGHT == Board::HEIGHT, "board size differs from Board");
+static_assert(TETRIS_PREVIEW == Randomizer::PREVIEW, "preview length differs from Randomizer");
+static_assert(TETRIS_MOVE_LEFT == Engine::MOVE_LEFT && TETRIS_MOVE_RIGHT == Engine::MOVE_RIGHT &&
+                  TETRIS_SOFT_DROP == Engine::SOFT_DROP && TETRIS_ROTATE == Engine::ROTATE &&
+                  TETRIS_HARD_DROP == Engine::HARD_DROP,
+              "action values differ from Engine::Action");
+static_assert(TETRIS_RANDOMIZER_UNIFORM == Randomizer::UNIFORM && TETRIS_RANDOMIZER_BAG == Randomizer::BAG,
+              "randomizer values differ from Randomizer::Mode");
+static_assert(sizeof(tetris_observation) == TETRIS_HEIGHT * TETRIS_WIDTH + 16 * sizeof(int32_t),
+              "tetris_observation must not contain padding");
+
+struct tetris_env
+{
+    Engine engine;
+    int reward; // Lines cleared by the last step
+
+    tetris_env(uint32_t seed, Randomizer::Mode mode) : engine(seed, mode), reward(0) {}
+};
+
+struct tetris_batch
+{
+    std::vector<Engine> engines;
+    uint32_t nextSeed; // Seed of the next game to restart
+
+    tetris_batch(int count, uint32_t firstSeed, Randomizer::Mode mode) : nextSeed(firstSeed + count)
+    {
+        engines.reserve(count);
+        for (int i = 0; i < count; ++i)
+            engines.emplace_back(firstSeed + i, mode);
+    }
+};
+
+namespace
+{
+    // Accepts only the randomizer values the header defines
+    bool toMode(int randomizer, Randomizer::Mode &mode)
+    {
+        if (randomizer != TETRIS_RANDOMIZER_UNIFORM && randomizer != TETRIS_RANDOMIZER_BAG)
+            return false;
+        mode = static_cast<Randomizer::Mode>(randomizer);
+        return true;
+    }
+
+    // Single actions that would change the piece, tested with the board's own move rules
+    uint32_t legalActions(const Engine &engine)
+    {
+        if (engine.isGameOver())
+            return 0;
+        const Board &board = engine.getBoard();
+        Tetromino left = engine.getCurrentPiece(), right = left, down = left, turned = left;
+        uint32_t legal = TETRIS_HARD_DROP;
+        if (board.movePiece(left, -1, 0))
+            legal |= TETRIS_MOVE_LEFT;
+        if (board.movePiece(right, 1, 0))
+            legal |= TETRIS_MOVE_RIGHT;
+        if (board.movePiece(down, 0, 1))
+            legal |= TETRIS_SOFT_DROP;
+        if (board.rotatePiece(turned))
+            legal |= TETRIS_ROTATE;
+        return legal;
+    }
+
+    // Fills a caller's observation in place: occupancy from the row masks, then the falling piece on top
+    void observe(const Engine &engine, int reward, tetris_observation *obs)
+    {
+        const Board &board = engine.getBoard();
+        for (int y = 0; y < Board::HEIGHT; ++y)
+        {
+            unsigned row = board.rowBits(y) >> Board::WALL_BITS;
+            for (int x = 0; x < Board::WIDTH; ++x)
+                obs->board[y][x] = static_cast<uint8_t>((row >> x) & 1);
+        }
+
+        const Tetromino &piece = engine.getCurrentPiece();
+        for (const PieceShape::Cell &cell : piece.getShape().cells)
+        {
+            int x = piece.getX() + cell.x;
+            int y = piece.getY() + cell.y;
+            if (x >= 0 && x < Board::WIDTH && y >= 0 && y < Board::HEIGHT)
+                obs->board[y][x] = TETRIS_CELL_PIECE;
+        }
+
+        obs->piece = piece.getType();
+        obs->piece_x = piece.getX();
+        obs->piece_y = piece.getY();
+        obs->piece_rotation = piece.getRotation();
+        for (int i = 0; i < Randomizer::PREVIEW; ++i)
+            obs->next[i] = engine.getNextPiece(i);
+        obs->score = engine.getScore();
+        obs->lines = engine.getLinesCleared();
+        obs->level = engine.getLevel();
+        obs->reward = reward;
+        obs->legal_actions = legalActions(engine);
+        obs->done = engine.isGameOver() ? 1 : 0;
+    }
+}
+
+// Version of the C interface this library was built with
+int tetris_abi_version(void)
+{
+    return TETRIS_ABI_VERSION;
+}
+
+// Lets callers check their tetris_observation layout against the library's
+int tetris_observation_size(void)
+{
+    return static_cast<int>(sizeof(tetris_observation));
+}
+
+// Creates one game; allocation failures are reported as NULL rather than thrown across the C boundary
+tetris_env *tetris_create(uint32_t seed, int randomizer)
+{
+    Randomizer::Mode mode;
+    if (!toMode(randomizer, mode))
+        return nullptr;
+    return new (std::nothrow) tetris_env(seed, mode);
+}
+
+// Frees a game from tetris_create (NULL is ignored)
+void tetris_destroy(tetris_env *env)
+{
+    delete env;
+}
+
+// Starts a new game with seed in the same environment
+void tetris_reset(tetris_env *env, uint32_t seed, tetris_observation *obs)
+{
+    env->engine.reset(seed);
+    env->reward = 0;
+    if (obs != nullptr)
+        observe(env->engine, 0, obs);
+}
+
+// Runs one frame with actions; returns the lines it cleared
+int tetris_step(tetris_env *env, uint32_t actions, tetris_observation *obs)
+{
+    env->reward = env->engine.step(actions).lines;
+    if (obs != nullptr)
+        observe(env->engine, env->reward, obs);
+    return env->reward;
+}
+
+// Single actions that would change the falling piece right now
+uint32_t tetris_legal_actions(const tetris_env *env)
+{
+    return legalActions(env->engine);
+}
+
+// Writes the current state without advancing the game
+void tetris_observe(const tetris_env *env, tetris_observation *obs)
+{
+    observe(env->engine, env->reward, obs);
+}
+
+// The engines are allocated inside the constructor too, so every exception it can throw is caught
+tetris_batch *tetris_batch_create(int count, uint32_t first_seed, int randomizer)
+{
+    Randomizer::Mode mode;
+    if (count < 1 || !toMode(randomizer, mode))
+        return nullptr;
+    try
+    {
+        return new tetris_batch(count, first_seed, mode);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+// Frees a batch from tetris_batch_create (NULL is ignored)
+void tetris_batch_destroy(tetris_batch *batch)
+{
+    delete batch;
+}
+
+// Number of games in the batch
+int tetris_batch_size(const tetris_batch *batch)
+{
+    return static_cast<int>(batch->engines.size());
+}
+
+// Restarts every game with seeds first_seed, first_seed + 1, ... and writes their observations
+void tetris_batch_reset(tetris_batch *batch, uint32_t first_seed, tetris_observation *obs)
+{
+    int count = static_cast<int>(batch->engines.size());
+    for (int i = 0; i < count; ++i)
+    {
+        batch->engines[i].reset(first_seed + i);
+        if (obs != nullptr)
+            observe(batch->engines[i], 0, &obs[i]);
+    }
+    batch->nextSeed = first_seed + count;
+}
+
+// One frame for every game in a single call, so a foreign caller pays the call overhead once per batch
+int tetris_batch_step(tetris_batch *batch, const uint32_t *actions, tetris_observation *obs)
+{
+    int total = 0;
+    int count = static_cast<int>(batch->engines.size());
+    for (int i = 0; i < count; ++i)
+    {
+        Engine &engine = batch->engines[i];
+        int reward = 0;
+        if (engine.isGameOver())
+            engine.reset(batch->nextSeed++); // Its done flag was reported by the previous step
+        else
+            reward = engine.step(actions[i]).lines;
+        total += reward;
+        if (obs != nullptr)
+            observe(engine, reward, &obs[i]);
+    }
+    return total;
+}
@@ -0,0 +1,100 @@
+#ifndef TETRIS_API_H
+#define TETRIS_API_H
+
+/*
+ * Plain C interface to the game rules, for callers in other languages (ctypes, cffi, JNI, ...).
+ * Built into libtetris with -DTETRIS_NO_MAIN (see README). Every environment is an Engine, so the
+ * library plays by exactly the rules of the interactive game.
+ *
+ * Observations are written straight into caller-owned tetris_observation structs: stepping never
+ * allocates, and nothing is copied through intermediate buffers. The struct layout is fixed
+ * (plain int32/uint8 fields, no padding), so it can be mapped as a structured array; check
+ * tetris_observation_size() against your own definition before using it.
+ */
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+#define TETRIS_API __declspec(dllexport)
+#elif defined(__GNUC__)
+#define TETRIS_API __attribute__((visibility("default")))
+#else
+#define TETRIS_API
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define TETRIS_ABI_VERSION 1 /* Bumped whenever a signature or tetris_observation changes */
+
+#define TETRIS_WIDTH 10  /* Board columns */
+#define TETRIS_HEIGHT 20 /* Board rows */
+#define TETRIS_PREVIEW 6 /* Upcoming pieces in each observation */
+
+/* Actions for one frame (combine with |); same values as Engine::Action */
+#define TETRIS_MOVE_LEFT 1
+#define TETRIS_MOVE_RIGHT 2
+#define TETRIS_SOFT_DROP 4
+#define TETRIS_ROTATE 8
+#define TETRIS_HARD_DROP 16
+
+/* Piece randomizers; same values as Randomizer::Mode */
+#define TETRIS_RANDOMIZER_UNIFORM 0
+#define TETRIS_RANDOMIZER_BAG 1
+
+/* Values in tetris_observation.board */
+#define TETRIS_CELL_EMPTY 0
+#define TETRIS_CELL_BLOCK 1 /* Settled block */
+#define TETRIS_CELL_PIECE 2 /* Falling piece */
+
+/* Game state after reset or step. Piece types are 0-6 in the order I, O, T, S, Z, J, L. */
+typedef struct tetris_observation
+{
+    uint8_t board[TETRIS_HEIGHT][TETRIS_WIDTH]; /* Row 0 is the top */
+    int32_t piece;                              /* Current piece type */
+    int32_t piece_x;                            /* Position of its 4x4 box */
+    int32_t piece_y;
+    int32_t piece_rotation;                     /* 0-3, clockwise */
+    int32_t next[TETRIS_PREVIEW];               /* Upcoming piece types, next[0] first */
+    int32_t score;
+    int32_t lines;                              /* Lines cleared in this game */
+    int32_t level;
+    int32_t reward;                             /* Lines cleared by the last step */
+    uint32_t legal_actions;                     /* Single actions that would change the piece (hard drop always) */
+    int32_t done;                               /* 1 once the game is over */
+} tetris_observation;
+
+typedef struct tetris_env tetris_env;     /* One game */
+typedef struct tetris_batch tetris_batch; /* Many games stepped by one call */
+
+TETRIS_API int tetris_abi_version(void);
+TETRIS_API int tetris_observation_size(void); /* sizeof(tetris_observation) */
+
+/* Single environment. create returns NULL for an unknown randomizer. Each function writes the
+   resulting state into *obs when obs is not NULL. step returns the lines it cleared; stepping a
+   finished game does nothing until the next reset. */
+TETRIS_API tetris_env *tetris_create(uint32_t seed, int randomizer);
+TETRIS_API void tetris_destroy(tetris_env *env);
+TETRIS_API void tetris_reset(tetris_env *env, uint32_t seed, tetris_observation *obs);
+TETRIS_API int tetris_step(tetris_env *env, uint32_t actions, tetris_observation *obs);
+TETRIS_API uint32_t tetris_legal_actions(const tetris_env *env);
+TETRIS_API void tetris_observe(const tetris_env *env, tetris_observation *obs);
+
+/* Batch of count games with seeds first_seed, first_seed + 1, ... Step applies actions[i] to game
+   i and writes obs[i] for every game. A game that ends reports done = 1 with its final state; the
+   next step restarts it with the next unused seed instead of applying its action, so callers never
+   reset games themselves. create returns NULL for count < 1, an unknown randomizer or games that
+   cannot be allocated. Step returns the total lines cleared by the call. */
+TETRIS_API tetris_batch *tetris_batch_create(int count, uint32_t first_seed, int randomizer);
+TETRIS_API void tetris_batch_destroy(tetris_batch *batch);
+TETRIS_API int tetris_batch_size(const tetris_batch *batch);
+TETRIS_API void tetris_batch_reset(tetris_batch *batch, uint32_t first_seed, tetris_observation *obs);
+TETRIS_API int tetris_batch_step(tetris_batch *batch, const uint32_t *actions, tetris_observation *obs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,7 +1,50 @@
 #ifndef TETROMINO_H
 #define TETROMINO_H
 
-#include <vector>
+#include <cstdint>
+
+template <int W, int H>
+class BasicBoard; // Forward declaration (Board.h includes this header)
+
+// Precomputed geometry of one piece in one rotation
+struct PieceShape
+{
+    static const int SIZE = 4; // Every piece has 4 cells and fits in a 4x4 box
+
+    struct Cell
+    {
+        int8_t x, y;
+    };
+
+    Cell cells[SIZE];       // Cell offsets from the piece position
+    uint8_t rowMasks[SIZE]; // Bit dx of rowMasks[dy] is set for cell (dx, dy)
+    int8_t minX, maxX;      // Horizontal bounding box of the cells
+    int8_t minY, maxY;      // Vertical bounding box of the cells
+    int8_t bottoms[SIZE];   // Lowest cell offset in each column dx (-1 if the column is empty)
+};
+
+// Builds a PieceShape (masks and bounding box included) from its four cell offsets at compile time
+constexpr PieceShape makePieceShape(int x0, int y0, int x1, int y1, int x2, int y2, int x3, int y3)
+{
+    PieceShape shape{};
+    const int xs[PieceShape::SIZE] = {x0, x1, x2, x3};
+    const int ys[PieceShape::SIZE] = {y0, y1, y2, y3};
+    shape.minX = shape.minY = PieceShape::SIZE;
+    shape.maxX = shape.maxY = -1;
+    for (int i = 0; i < PieceShape::SIZE; ++i)
+        shape.bottoms[i] = -1;
+    for (int i = 0; i < PieceShape::SIZE; ++i)
+    {
+        shape.cells[i] = {static_cast<int8_t>(xs[i]), static_cast<int8_t>(ys[i])};
+        shape.rowMasks[ys[i]] = static_cast<uint8_t>(shape.rowMasks[ys[i]] | (1u << xs[i]));
+        shape.minX = static_cast<int8_t>(xs[i] < shape.minX ? xs[i] : shape.minX);
+        shape.maxX = static_cast<int8_t>(xs[i] > shape.maxX ? xs[i] : shape.maxX);
+        shape.minY = static_cast<int8_t>(ys[i] < shape.minY ? ys[i] : shape.minY);
+        shape.maxY = static_cast<int8_t>(ys[i] > shape.maxY ? ys[i] : shape.maxY);
+        shape.bottoms[xs[i]] = static_cast<int8_t>(ys[i] > shape.bottoms[xs[i]] ? ys[i] : shape.bottoms[xs[i]]);
+    }
+    return shape;
+}
 
 // Tetromino class represents a Tetris piece (shape, position, rotation)
 class Tetromino
@@ -21,7 +64,7 @@ public:
 
     Tetromino(Type type); // Constructor - creates a piece of given type
 
-    static Tetromino getRandomPiece(); // Static function to generate a random piece
+    static char typeChar(Type type) { return pieceChars[type]; } // Character drawn for a piece type
 
     // Movement and rotation
     void move(int dx, int dy);      // Move horizontally or vertically
@@ -29,21 +72,67 @@ public:
     void rotateBack();              // Undo rotation (90 degrees counter-clockwise)
     void setPosition(int x, int y); // Set initial position (usually at top-center)
 
-    // Drawing and collision handling
-    void draw(char grid[20][10]) const;               // Draw piece onto the given grid
-    void placeOnBoard(char grid[20][10]) const;       // Permanently place the piece
-    bool collidesWith(const char grid[20][10]) const; // Check if it overlaps with existing blocks
+    // Current state of the piece
+    Type getType() const { return type; }
+    int getX() const { return x; }
+    int getY() const { return y; }
+    int getRotation() const { return rotation; }
+    const PieceShape &getShape() const { return shapes[type][rotation]; }
+    static const PieceShape &shapeOf(Type type, int rotation) { return shapes[type][rotation]; } // Geometry without a piece object
+
+    // Drawing and collision handling, for a board of any size (defined in Board.h)
+    template <int W, int H>
+    void draw(BasicBoard<W, H> &board) const; // Draw piece onto the given board (clipped to its bounds)
+    template <int W, int H>
+    void placeOnBoard(BasicBoard<W, H> &board) const; // Permanently place the piece
+    template <int W, int H>
+    bool collidesWith(const BasicBoard<W, H> &board) const; // Check if it overlaps with walls, floor or existing blocks
 
 private:
     Type type;    // Type of the piece (I, O, T, etc.)
     int x, y;     // Current position on the board
     int rotation; // Current rotation (0, 1, 2, 3)
 
-    // Shape definitions (each type has 4 rotations)
-    static const std::vector<std::vector<std::vector<std::pair<int, int>>>> shapes;
+    // Shape definitions (each type has 4 rotations), built at compile time
+    static constexpr PieceShape shapes[7][4] = {
+        {// I-piece (line)
+         makePieceShape(0, 0, 1, 0, 2, 0, 3, 0),
+         makePieceShape(0, 0, 0, 1, 0, 2, 0, 3),
+         makePieceShape(0, 0, 1, 0, 2, 0, 3, 0),
+         makePieceShape(0, 0, 0, 1, 0, 2, 0, 3)},
+        {// O-piece (square)
+         makePieceShape(0, 0, 1, 0, 0, 1, 1, 1),
+         makePieceShape(0, 0, 1, 0, 0, 1, 1, 1),
+         makePieceShape(0, 0, 1, 0, 0, 1, 1, 1),
+         makePieceShape(0, 0, 1, 0, 0, 1, 1, 1)},
+        {// T-piece
+         makePieceShape(1, 0, 0, 1, 1, 1, 2, 1),
+         makePieceShape(1, 0, 1, 1, 2, 1, 1, 2),
+         makePieceShape(0, 1, 1, 1, 2, 1, 1, 2),
+         makePieceShape(1, 0, 0, 1, 1, 1, 1, 2)},
+        {// S-piece
+         makePieceShape(1, 0, 2, 0, 0, 1, 1, 1),
+         makePieceShape(1, 0, 1, 1, 2, 1, 2, 2),
+         makePieceShape(1, 1, 2, 1, 0, 2, 1, 2),
+         makePieceShape(0, 0, 0, 1, 1, 1, 1, 2)},
+        {// Z-piece
+         makePieceShape(0, 0, 1, 0, 1, 1, 2, 1),
+         makePieceShape(2, 0, 1, 1, 2, 1, 1, 2),
+         makePieceShape(0, 1, 1, 1, 1, 2, 2, 2),
+         makePieceShape(1, 0, 0, 1, 1, 1, 0, 2)},
+        {// J-piece
+         makePieceShape(0, 0, 0, 1, 1, 1, 2, 1),
+         makePieceShape(1, 0, 2, 0, 1, 1, 1, 2),
+         makePieceShape(0, 1, 1, 1, 2, 1, 2, 2),
+         makePieceShape(1, 0, 1, 1, 0, 2, 1, 2)},
+        {// L-piece
+         makePieceShape(2, 0, 0, 1, 1, 1, 2, 1),
+         makePieceShape(1, 0, 1, 1, 1, 2, 2, 2),
+         makePieceShape(0, 1, 1, 1, 2, 1, 0, 2),
+         makePieceShape(0, 0, 1, 0, 1, 1, 1, 2)}};
 
     // Character used to represent each piece type on the board
-    static const char pieceChars[7];
+    static constexpr char pieceChars[7] = {'I', 'O', 'T', 'S', 'Z', 'J', 'L'};
 };
 
 #endif
@@ -0,0 +1,118 @@
+#include "ThreadPool.h"
+
+namespace
+{
+    // Index of the pool worker running on this thread (-1 outside the pool)
+    thread_local int currentWorker = -1;
+}
+
+// Constructor - start the worker threads, each with its own queue
+ThreadPool::ThreadPool(unsigned threadCount)
+    : queued(0), pending(0), nextQueue(0), steals(0), stopping(false)
+{
+    if (threadCount == 0)
+        threadCount = std::thread::hardware_concurrency();
+    if (threadCount == 0)
+        threadCount = 1;
+
+    for (unsigned i = 0; i < threadCount; ++i)
+        queues.emplace_back(new TaskQueue());
+    for (unsigned i = 0; i < threadCount; ++i)
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+// Destructor - let queued work drain, then stop and join every worker
+ThreadPool::~ThreadPool()
+{
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    workReady.notify_all();
+    for (std::thread &worker : workers)
+        worker.join();
+}
+
+// Queues a task; tasks submitted from a worker stay on that worker's queue
+void ThreadPool::submit(std::function<void()> task)
+{
+    unsigned index = currentWorker >= 0 ? static_cast<unsigned>(currentWorker)
+                                        : nextQueue.fetch_add(1) % queues.size();
+    pending.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        queued.fetch_add(1);
+    }
+    workReady.notify_one();
+}
+
+// Blocks until all submitted tasks have run
+void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> lock(stateMutex);
+    allDone.wait(lock, [this]
+                 { return pending.load() == 0; });
+}
+
+// Worker thread: run local tasks, steal when empty, sleep when there is nothing anywhere
+void ThreadPool::workerLoop(unsigned index)
+{
+    currentWorker = static_cast<int>(index);
+    std::function<void()> task;
+    while (true)
+    {
+        if (takeTask(index, task))
+        {
+            task();
+            task = nullptr;
+            if (pending.fetch_sub(1) == 1)
+            {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                allDone.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(stateMutex);
+        workReady.wait(lock, [this]
+                       { return stopping || queued.load() > 0; });
+        if (stopping && queued.load() == 0)
+            return;
+    }
+}
+
+// Takes the newest task from our own queue, or the oldest task from another worker's queue
+bool ThreadPool::takeTask(unsigned index, std::function<void()> &task)
+{
+    {
+        TaskQueue &own = *queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty())
+        {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+
+    for (size_t offset = 1; offset < queues.size(); ++offset)
+    {
+        TaskQueue &victim = *queues[(index + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty())
+        {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queued.fetch_sub(1);
+            steals.fetch_add(1);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,55 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ThreadPool runs tasks on a fixed set of worker threads. Every worker owns a queue;
+// a worker that runs out of work steals from the other queues, so uneven task lengths
+// (games that last 10 pieces next to games that last 100000) still keep all cores busy.
+class ThreadPool
+{
+public:
+    explicit ThreadPool(unsigned threadCount = 0); // Constructor - 0 uses one thread per hardware core
+    ~ThreadPool();                                 // Finishes queued tasks and joins the workers
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    void submit(std::function<void()> task); // Queues a task
+    void wait();                             // Blocks until every submitted task has finished
+
+    unsigned size() const { return static_cast<unsigned>(workers.size()); } // Number of worker threads
+    unsigned long getSteals() const { return steals.load(); }             // Tasks taken from another worker's queue
+
+private:
+    // Task queue owned by one worker; the owner pops from the back, thieves take from the front
+    struct TaskQueue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<TaskQueue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex stateMutex;             // Guards sleeping and completion waits
+    std::condition_variable workReady; // Signalled when tasks are queued or the pool stops
+    std::condition_variable allDone;   // Signalled when the last pending task finishes
+    std::atomic<long> queued;          // Tasks sitting in queues
+    std::atomic<long> pending;         // Tasks submitted but not yet finished
+    std::atomic<unsigned> nextQueue;   // Round-robin target for submissions from outside the pool
+    std::atomic<unsigned long> steals; // Number of successful steals
+    bool stopping;                     // Set by the destructor
+
+    void workerLoop(unsigned index);                            // Body of each worker thread
+    bool takeTask(unsigned index, std::function<void()> &task); // Pops local work or steals
+};
+
+#endif
@@ -0,0 +1,125 @@
+#include "TranspositionTable.h"
+#include <cstring>
+
+namespace
+{
+    const uint64_t VALID_BIT = 1ull << 48; // Set in every stored entry so that data 0 means empty
+}
+
+// Constructor - allocates 2^sizeLog2 empty buckets
+TranspositionTable::TranspositionTable(int sizeLog2, Replacement replacement)
+    : buckets(new Bucket[size_t(1) << sizeLog2]), bucketCount(size_t(1) << sizeLog2), replacement(replacement), generation(0)
+{
+    clear();
+}
+
+// Data layout: score bits (0-31), depth (32-39), generation (40-47), valid bit (48)
+uint64_t TranspositionTable::pack(const Value &value, uint32_t generation)
+{
+    uint32_t scoreBits;
+    std::memcpy(&scoreBits, &value.score, sizeof(scoreBits));
+    uint64_t depth = static_cast<uint64_t>(value.depth < 0 ? 0 : (value.depth > 255 ? 255 : value.depth));
+    return scoreBits | (depth << 32) | (static_cast<uint64_t>(generation & 0xFF) << 40) | VALID_BIT;
+}
+
+TranspositionTable::Value TranspositionTable::unpack(uint64_t data)
+{
+    Value value;
+    uint32_t scoreBits = static_cast<uint32_t>(data);
+    std::memcpy(&value.score, &scoreBits, sizeof(scoreBits));
+    value.depth = depthOf(data);
+    return value;
+}
+
+// Checks both slots of the key's bucket
+bool TranspositionTable::probe(uint64_t key, Value &value)
+{
+    Bucket &bucket = buckets[key & (bucketCount - 1)];
+    bool occupied = false;
+    for (Slot &slot : bucket.slots)
+    {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t check = slot.check.load(std::memory_order_relaxed);
+        if (data == 0)
+            continue;
+        if ((check ^ data) == key)
+        {
+            value = unpack(data);
+            hits.value.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        occupied = true;
+    }
+
+    misses.value.fetch_add(1, std::memory_order_relaxed);
+    if (occupied)
+        collisions.value.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+// Picks a slot according to the replacement policy and writes the entry
+void TranspositionTable::store(uint64_t key, const Value &value)
+{
+    Bucket &bucket = buckets[key & (bucketCount - 1)];
+    uint32_t currentGeneration = generation.load(std::memory_order_relaxed);
+    uint64_t data = pack(value, currentGeneration);
+
+    Slot *target = &bucket.slots[0];
+    if (replacement != ALWAYS)
+    {
+        uint64_t existing = target->data.load(std::memory_order_relaxed);
+        uint64_t existingCheck = target->check.load(std::memory_order_relaxed);
+        bool samePosition = (existingCheck ^ existing) == key;
+        bool keep = existing != 0 && !samePosition && depthOf(existing) > value.depth &&
+                    generationOf(existing) == (currentGeneration & 0xFF);
+        if (keep)
+        {
+            if (replacement == DEPTH_PREFERRED)
+            {
+                rejected.value.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            target = &bucket.slots[1]; // TWO_TIER: the second slot always takes it
+        }
+    }
+
+    target->data.store(data, std::memory_order_relaxed);
+    target->check.store(key ^ data, std::memory_order_relaxed);
+    stores.value.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Entries from earlier searches no longer block the depth-preferred slot
+void TranspositionTable::newSearch()
+{
+    generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Empties every slot and resets the counters (not safe while other threads use the table)
+void TranspositionTable::clear()
+{
+    for (size_t i = 0; i < bucketCount; ++i)
+    {
+        for (Slot &slot : buckets[i].slots)
+        {
+            slot.data.store(0, std::memory_order_relaxed);
+            slot.check.store(0, std::memory_order_relaxed);
+        }
+    }
+    hits.value.store(0);
+    misses.value.store(0);
+    collisions.value.store(0);
+    stores.value.store(0);
+    rejected.value.store(0);
+}
+
+// Snapshot of the counters
+TranspositionTable::Counters TranspositionTable::getCounters() const
+{
+    Counters counters;
+    counters.hits = hits.value.load(std::memory_order_relaxed);
+    counters.misses = misses.value.load(std::memory_order_relaxed);
+    counters.collisions = collisions.value.load(std::memory_order_relaxed);
+    counters.stores = stores.value.load(std::memory_order_relaxed);
+    counters.rejected = rejected.value.load(std::memory_order_relaxed);
+    return counters;
+}
@@ -0,0 +1,85 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Fixed-size hash table of evaluated search positions, keyed by Board::positionKey, shared by all
+// search threads without locks. Each slot is two 64-bit atomics holding (key ^ data) and data; a
+// reader accepts an entry only if the two agree with its key, so a write torn by another thread
+// reads as a miss instead of a wrong value.
+class TranspositionTable
+{
+public:
+    // What happens when a new position maps to an occupied bucket
+    enum Replacement
+    {
+        ALWAYS,          // The newest position always wins (one slot per bucket)
+        DEPTH_PREFERRED, // Keep the deeper search unless the entry is from an older search (one slot)
+        TWO_TIER         // One depth-preferred slot plus one always-replace slot per bucket
+    };
+
+    // What is stored for a position
+    struct Value
+    {
+        float score; // Evaluation of the position
+        int depth;   // Search depth the score came from (0-255)
+    };
+
+    // Lookup statistics since the last clear()
+    struct Counters
+    {
+        uint64_t hits;       // Probes that found their position
+        uint64_t misses;     // Probes that did not
+        uint64_t collisions; // Misses where the bucket held other positions (the table may be too small)
+        uint64_t stores;     // Positions written
+        uint64_t rejected;   // Stores refused by the depth-preferred rule
+    };
+
+    explicit TranspositionTable(int sizeLog2 = 20, Replacement replacement = TWO_TIER); // 2^sizeLog2 buckets
+
+    bool probe(uint64_t key, Value &value);       // Looks a position up; returns true and fills value on a hit
+    void store(uint64_t key, const Value &value); // Records a position according to the replacement policy
+    void newSearch();                             // Ages existing entries so the depth-preferred slot accepts new ones
+    void clear();                                 // Empties the table and resets the counters
+
+    Counters getCounters() const;
+    size_t getBucketCount() const { return bucketCount; }
+    Replacement getReplacement() const { return replacement; }
+
+private:
+    static const int SLOTS = 2; // Slots per bucket (the second is only used by TWO_TIER)
+
+    struct Slot
+    {
+        std::atomic<uint64_t> check; // key ^ data
+        std::atomic<uint64_t> data;  // Packed Value and generation (0 = empty)
+    };
+
+    struct alignas(32) Bucket
+    {
+        Slot slots[SLOTS];
+    };
+
+    // Each counter on its own cache line so threads updating different counters do not collide
+    struct alignas(64) Counter
+    {
+        std::atomic<uint64_t> value;
+    };
+
+    std::unique_ptr<Bucket[]> buckets;
+    size_t bucketCount;
+    Replacement replacement;
+    std::atomic<uint32_t> generation; // Incremented by newSearch()
+
+    Counter hits, misses, collisions, stores, rejected;
+
+    static uint64_t pack(const Value &value, uint32_t generation);
+    static Value unpack(uint64_t data);
+    static int depthOf(uint64_t data) { return static_cast<int>((data >> 32) & 0xFF); }
+    static uint32_t generationOf(uint64_t data) { return static_cast<uint32_t>((data >> 40) & 0xFF); }
+};
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+// TripleBuffer hands complete values from one writer thread to one reader thread without either
+// side ever waiting. The writer fills its own slot and swaps it with the shared middle slot in a
+// single atomic exchange; the reader swaps the middle slot with its own when something new is
+// there. The reader therefore always sees the newest complete value, and a value the writer
+// replaces before the reader got to it is simply dropped (publish() reports it).
+template <typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer() : middle(1), writeIndex(0), readIndex(2) {}
+
+    TripleBuffer(const TripleBuffer &) = delete;
+    TripleBuffer &operator=(const TripleBuffer &) = delete;
+
+    // Writer side: the slot to fill next. It is not shared until publish().
+    T &draft() { return slots[writeIndex]; }
+
+    // Shares the draft as the newest value and takes back a free slot. Returns true if the value
+    // it replaced was never taken by the reader.
+    bool publish()
+    {
+        uint8_t previous = middle.exchange(static_cast<uint8_t>(writeIndex | FRESH), std::memory_order_acq_rel);
+        writeIndex = previous & INDEX;
+        return (previous & FRESH) != 0;
+    }
+
+    // Reader side: whether a value has been published since the last take()
+    bool hasFresh() const { return (middle.load(std::memory_order_acquire) & FRESH) != 0; }
+
+    // Makes the newest value current; false (and latest() unchanged) if nothing new was published
+    bool take()
+    {
+        if (!hasFresh())
+            return false;
+        uint8_t previous = middle.exchange(readIndex, std::memory_order_acq_rel);
+        readIndex = previous & INDEX;
+        return true;
+    }
+
+    const T &latest() const { return slots[readIndex]; } // Value made current by the last take()
+
+private:
+    static const uint8_t INDEX = 3; // Slot index bits of middle
+    static const uint8_t FRESH = 4; // Set while middle holds a value the reader has not taken
+
+    T slots[3];
+    alignas(64) std::atomic<uint8_t> middle; // Index of the shared slot, plus FRESH
+    alignas(64) uint8_t writeIndex;          // Owned by the writer
+    alignas(64) uint8_t readIndex;           // Owned by the reader
+};
+
+#endif
@@ -0,0 +1,165 @@
+#include "VecEnv.h"
+#include "Engine.h"
+
+// Constructor - allocates every array once and starts count games
+VecEnv::VecEnv(int count, uint64_t firstSeed, Randomizer::Mode mode)
+    : count(count), nextSeed(firstSeed), rows(static_cast<size_t>(count) * ROWS), type(count), rotation(count),
+      x(count), y(count), score(count), level(count), linesCleared(count), frame(count), reward(count), done(count),
+      randomizers(count, Randomizer(0, mode)), episodes(0), finishedScore(0)
+{
+    reset(firstSeed);
+}
+
+// Restarts every game from consecutive seeds
+void VecEnv::reset(uint64_t firstSeed)
+{
+    nextSeed = firstSeed;
+    for (int game = 0; game < count; ++game)
+    {
+        resetGame(game);
+        reward[game] = 0;
+        done[game] = 0;
+    }
+    episodes = 0;
+    finishedScore = 0;
+}
+
+// Empty board (with the floor rows below it) and the first piece of a new sequence
+void VecEnv::resetGame(int game)
+{
+    Board::Row *board = &rows[static_cast<size_t>(game) * ROWS];
+    for (int row = 0; row < Board::HEIGHT; ++row)
+        board[row] = Board::EMPTY_ROW;
+    for (int row = Board::HEIGHT; row < ROWS; ++row)
+        board[row] = Board::FULL_ROW;
+
+    score[game] = 0;
+    level[game] = 1;
+    linesCleared[game] = 0;
+    frame[game] = 0;
+    randomizers[game].reset(nextSeed++, randomizers[game].getMode());
+    spawn(game);
+}
+
+// Walls are padding bits and the floor is full rows below the board, so a piece position is
+// tested with four ANDs and no bounds checks (rows of the mask below the piece are zero)
+inline bool VecEnv::collides(int game, int pieceType, int pieceRotation, int pieceX, int pieceY) const
+{
+    const PieceShape &shape = Tetromino::shapeOf(static_cast<Tetromino::Type>(pieceType), pieceRotation);
+    const Board::Row *board = &rows[static_cast<size_t>(game) * ROWS + pieceY];
+    int shift = pieceX + Board::WALL_BITS;
+    unsigned hit = ((shape.rowMasks[0] << shift) & board[0]) | ((shape.rowMasks[1] << shift) & board[1]) |
+                   ((shape.rowMasks[2] << shift) & board[2]) | ((shape.rowMasks[3] << shift) & board[3]);
+    return hit != 0;
+}
+
+// Takes the next piece at the spawn position; a blocked spawn ends the game
+void VecEnv::spawn(int game)
+{
+    type[game] = static_cast<uint8_t>(randomizers[game].next());
+    rotation[game] = 0;
+    x[game] = Board::WIDTH / 2 - 1;
+    y[game] = 0;
+    if (collides(game, type[game], 0, x[game], 0))
+        done[game] = 1;
+}
+
+// Locks the piece, clears the full rows it completed, scores them and spawns the next piece
+void VecEnv::lock(int game)
+{
+    Board::Row *board = &rows[static_cast<size_t>(game) * ROWS];
+    const PieceShape &shape = Tetromino::shapeOf(static_cast<Tetromino::Type>(type[game]), rotation[game]);
+    int shift = x[game] + Board::WALL_BITS;
+    int top = y[game] + shape.minY;
+    int bottom = y[game] + shape.maxY;
+    int full = 0;
+    for (int row = top; row <= bottom; ++row)
+    {
+        board[row] |= static_cast<Board::Row>(shape.rowMasks[row - y[game]] << shift);
+        full += board[row] == Board::FULL_ROW;
+    }
+
+    if (full > 0)
+    { // Compact the rows from the lowest touched one upwards
+        int write = bottom;
+        for (int read = bottom; read >= 0; --read)
+        {
+            if (board[read] != Board::FULL_ROW)
+                board[write--] = board[read];
+        }
+        for (; write >= 0; --write)
+            board[write] = Board::EMPTY_ROW;
+
+        linesCleared[game] += full;
+        score[game] += full * Engine::POINTS_PER_LINE;
+        reward[game] = static_cast<uint8_t>(reward[game] + full);
+    }
+    if (linesCleared[game] >= level[game] * Engine::LINES_PER_LEVEL)
+        level[game]++;
+
+    spawn(game);
+}
+
+// Same order as Engine::step: left, right, soft drop, rotate, hard drop, then gravity.
+// Each move computes its candidate unconditionally (a no-op when the action bit is clear,
+// since the current position always fits) and keeps it only if it fits.
+void VecEnv::step(const uint8_t *actions)
+{
+    for (int game = 0; game < count; ++game)
+    {
+        reward[game] = 0;
+        done[game] = 0;
+
+        unsigned action = actions[game];
+        int pieceType = type[game];
+        int pieceRotation = rotation[game];
+        int pieceX = x[game];
+        int pieceY = y[game];
+
+        int candidate = pieceX - static_cast<int>(action & Engine::MOVE_LEFT);
+        pieceX = collides(game, pieceType, pieceRotation, candidate, pieceY) ? pieceX : candidate;
+        candidate = pieceX + static_cast<int>((action & Engine::MOVE_RIGHT) >> 1);
+        pieceX = collides(game, pieceType, pieceRotation, candidate, pieceY) ? pieceX : candidate;
+        candidate = pieceY + static_cast<int>((action & Engine::SOFT_DROP) >> 2);
+        pieceY = collides(game, pieceType, pieceRotation, pieceX, candidate) ? pieceY : candidate;
+        candidate = (pieceRotation + static_cast<int>((action & Engine::ROTATE) >> 3)) & 3;
+        pieceRotation = collides(game, pieceType, candidate, pieceX, pieceY) ? pieceRotation : candidate;
+
+        if (action & Engine::HARD_DROP)
+        {
+            while (!collides(game, pieceType, pieceRotation, pieceX, pieceY + 1))
+                pieceY++;
+            rotation[game] = static_cast<uint8_t>(pieceRotation);
+            x[game] = static_cast<int8_t>(pieceX);
+            y[game] = static_cast<int8_t>(pieceY);
+            lock(game);
+
+            pieceType = type[game];
+            pieceRotation = 0;
+            pieceX = x[game];
+            pieceY = 0;
+        }
+
+        if (!done[game])
+        { // Gravity
+            int interval = Engine::BASE_GRAVITY_INTERVAL - level[game];
+            interval = interval < 1 ? 1 : interval;
+            bool falls = frame[game] % static_cast<uint32_t>(interval) == 0;
+            bool blocked = falls && collides(game, pieceType, pieceRotation, pieceX, pieceY + 1);
+            pieceY += falls && !blocked;
+            rotation[game] = static_cast<uint8_t>(pieceRotation);
+            x[game] = static_cast<int8_t>(pieceX);
+            y[game] = static_cast<int8_t>(pieceY);
+            if (blocked)
+                lock(game);
+            frame[game]++;
+        }
+
+        if (done[game])
+        { // Record the finished game and start the next one in its place
+            episodes++;
+            finishedScore += score[game];
+            resetGame(game);
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef VEC_ENV_H
+#define VEC_ENV_H
+
+#include "Board.h"
+#include "Randomizer.h"
+#include <cstdint>
+#include <vector>
+
+// VecEnv runs many games in lockstep for reinforcement learning. The state of all games is kept
+// in struct-of-arrays form (one array per field, indexed by game) and step() advances every game
+// by one frame with the same rules as Engine::step, using straight-line collision tests instead
+// of per-piece objects. A finished game is reset with the next seed in the same step and flagged
+// in getDone(), so callers never have to manage resets.
+class VecEnv
+{
+public:
+    static const int ROWS = Board::HEIGHT + PieceShape::SIZE; // Rows per game: the board plus full rows below the floor
+
+    VecEnv(int count, uint64_t firstSeed, Randomizer::Mode mode = Randomizer::UNIFORM); // Constructor - starts count games
+
+    void step(const uint8_t *actions); // One frame for every game: actions[i] (Engine action mask) then gravity
+    void reset(uint64_t firstSeed);    // Restarts every game; game i gets seed firstSeed + i
+
+    int size() const { return count; }
+
+    // Observations, all indexed by game
+    const Board::Row *getRows(int game) const { return &rows[static_cast<size_t>(game) * ROWS]; } // Board::HEIGHT row masks (walls included)
+    const uint8_t *getTypes() const { return type.data(); }       // Current piece types (Tetromino::Type)
+    const uint8_t *getRotations() const { return rotation.data(); }
+    const int8_t *getX() const { return x.data(); }
+    const int8_t *getY() const { return y.data(); }
+    const int32_t *getScores() const { return score.data(); }
+    const uint8_t *getRewards() const { return reward.data(); } // Lines cleared during the last step
+    const uint8_t *getDone() const { return done.data(); }      // 1 if the game ended during the last step (it has been reset)
+    Tetromino::Type getNextPiece(int game) const { return randomizers[game].peek(0); }
+
+    long getEpisodes() const { return episodes; }           // Games finished since construction or reset()
+    long getFinishedScore() const { return finishedScore; } // Total score of those games
+
+private:
+    int count;
+    uint64_t nextSeed; // Seed given to the next game that is reset
+
+    std::vector<Board::Row> rows; // count * ROWS row masks, game after game
+    std::vector<uint8_t> type;
+    std::vector<uint8_t> rotation;
+    std::vector<int8_t> x;
+    std::vector<int8_t> y;
+    std::vector<int32_t> score;
+    std::vector<int32_t> level;
+    std::vector<int32_t> linesCleared;
+    std::vector<uint32_t> frame;
+    std::vector<uint8_t> reward;
+    std::vector<uint8_t> done;
+    std::vector<Randomizer> randomizers;
+
+    long episodes;
+    long finishedScore;
+
+    bool collides(int game, int pieceType, int pieceRotation, int pieceX, int pieceY) const; // Piece overlaps walls, floor or blocks
+    void lock(int game);                                                                     // Places the piece, clears lines, spawns the next one
+    void spawn(int game);                                                                    // Takes the next piece; ends the game if it does not fit
+    void resetGame(int game);                                                                // Empty board, fresh seed
+};
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <cstdint>
+
+// Random 64-bit keys for Zobrist hashing. A board's hash is the XOR of the keys of its occupied
+// cells, so filling or emptying a cell updates it with a single XOR; the piece keys mix the type and
+// rotation of the current piece into a position key. The keys come from SplitMix64 at compile time,
+// so hashes are identical across runs, platforms and compilers.
+template <int WIDTH, int HEIGHT>
+struct ZobristKeys
+{
+    uint64_t cells[HEIGHT][WIDTH]; // Key of each occupied cell
+    uint64_t pieces[7][4];         // Key of each piece type and rotation
+};
+
+// SplitMix64 step, usable in constant expressions
+constexpr uint64_t zobristNext(uint64_t &state)
+{
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Fills a key table from a fixed seed at compile time
+template <int WIDTH, int HEIGHT>
+constexpr ZobristKeys<WIDTH, HEIGHT> makeZobristKeys()
+{
+    ZobristKeys<WIDTH, HEIGHT> keys{};
+    uint64_t state = 0x5A0B0B15ull;
+    for (int y = 0; y < HEIGHT; ++y)
+        for (int x = 0; x < WIDTH; ++x)
+            keys.cells[y][x] = zobristNext(state);
+    for (int type = 0; type < 7; ++type)
+        for (int rotation = 0; rotation < 4; ++rotation)
+            keys.pieces[type][rotation] = zobristNext(state);
+    return keys;
+}
+
+#endif
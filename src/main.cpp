@@ -1,10 +1,353 @@
 #include "Game.h" // Include the Game class header
+#include "BatchRunner.h"
+#include "Checkpoint.h"
+#include "Benchmark.h"
+#include "GameServer.h"
+#include "LoadGenerator.h"
+#include "Spectator.h"
+#include "Profiler.h"
+#include "Replay.h"
+#include "ScoreStore.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+// The shared library (libtetris) is built from the same sources with -DTETRIS_NO_MAIN
+#ifndef TETRIS_NO_MAIN
+
+namespace
+{
+    // Settings chosen on the command line
+    struct Options
+    {
+        int batchGames = 0;                                // Number of headless games to run (0 = interactive game)
+        unsigned seed = 1;                                 // Seed of the first batch game
+        unsigned threads = 0;                              // Worker threads for batch mode (0 = all cores)
+        long maxPieces = 100000;                           // Piece cap per batch game (0 = no cap)
+        const char *csv = nullptr;                         // Optional per-game CSV output for batch mode
+        Randomizer::Mode randomizer = Randomizer::UNIFORM; // Piece randomizer
+        const char *recordDir = nullptr;                   // Directory for replays of interactive games
+        int replayFirst = 0;                               // argv index of the first replay to verify (0 = none)
+        bool bench = false;                                // Run the microbenchmarks
+        const char *json = nullptr;                        // Benchmark JSON output ("-" = stdout)
+        bool autoplay = false;                             // Let the bot play the interactive game
+        bool fast = false;                                 // Autoplay without frame pacing
+        AutoPlayer::Settings autoPlayer;                   // Beam width and depth of the bot
+        const char *profile = "tetris-profile.txt";        // Stage timing report (profiling builds only)
+        const char *serve = nullptr;                       // Socket path to host games on
+        int maxSessions = 1024;                            // Games the server runs at once
+        const char *loadgen = nullptr;                     // Socket path of a server to load-test
+        LoadGenerator::Settings load;                      // Load generator clients, duration and rate
+        const char *broadcast = nullptr;                   // Publish the interactive game under this name
+        const char *watch = nullptr;                       // Broadcast to watch instead of playing
+        int watchFps = 30;                                 // Frames per second drawn while watching
+        const char *scoreFile = "tetris-scores.dat";       // Lifetime high score and statistics (nullptr = off)
+        bool stats = false;                                // Print the lifetime statistics and exit
+        const char *checkpoint = "tetris.checkpoint";      // File the S and L keys save to and resume from
+        const char *fork = nullptr;                        // Checkpoint to fork batch games from
+    };
+
+    // Prints command-line usage
+    void printUsage(const char *program)
+    {
+        std::cerr << "Usage: " << program << " [options]\n"
+                  << "  (no options)         Play the interactive game\n"
+                  << "  --batch N            Play N headless self-play games on all cores\n"
+                  << "  --seed S             Seed of the first batch game (default 1)\n"
+                  << "  --threads T          Worker threads for batch mode or the bot's search (default: all cores)\n"
+                  << "  --max-pieces P       Stop a batch game after P pieces (default 100000, 0 = no cap)\n"
+                  << "  --fork FILE          Play the batch games (default 1000) on from the checkpoint FILE\n"
+                  << "  --csv FILE           Write per-game batch results to FILE\n"
+                  << "  --randomizer R       Piece randomizer: uniform (default) or bag (7-bag)\n"
+                  << "  --autoplay           Let the beam-search bot play the game\n"
+                  << "  --fast               With --autoplay: play flat out, drawing once per piece\n"
+                  << "  --beam K             Boards the bot keeps per search level (default 8)\n"
+                  << "  --depth D            Pieces the bot looks ahead, current one included (default 2, max 7)\n"
+                  << "  --profile FILE       Stage timing report, written at exit and on SIGUSR1\n"
+                  << "                       (builds with -DTETRIS_PROFILE; default tetris-profile.txt)\n"
+                  << "  --serve PATH         Host games for clients on the Unix socket PATH (Linux)\n"
+                  << "  --max-sessions N     Games the server runs at once (default 1024)\n"
+                  << "  --loadgen PATH       Load-test the server at PATH with simulated players (Linux)\n"
+                  << "  --clients N          Players the load generator connects (default 100)\n"
+                  << "  --seconds S          Length of the load test (default 10)\n"
+                  << "  --broadcast NAME     Publish every frame to shared memory for spectators\n"
+                  << "  --watch NAME         Watch a broadcast game (Linux/macOS)\n"
+                  << "  --watch-fps N        Frames per second drawn while watching (default 30)\n"
+                  << "  --scores FILE        Keep the high score and lifetime statistics in FILE\n"
+                  << "                       (Linux/macOS; default tetris-scores.dat)\n"
+                  << "  --no-scores          Keep the high score for this session only\n"
+                  << "  --stats              Print the lifetime statistics from the score file\n"
+                  << "  --checkpoint FILE    File the S key saves the game to and L resumes it from\n"
+                  << "                       (default tetris.checkpoint)\n"
+                  << "  --record DIR         Save a replay of every interactive game into DIR\n"
+                  << "  --replay FILE...     Re-run replays at full speed and verify their final state\n"
+                  << "  --bench              Time the core board and piece operations\n"
+                  << "  --json FILE          Write benchmark results as JSON to FILE (- for stdout)\n";
+    }
+
+    // Parses argv into options, returning false on unknown or incomplete arguments
+    bool parseOptions(int argc, char *argv[], Options &options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const char *arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (std::strcmp(arg, "--batch") == 0 && hasValue)
+                options.batchGames = std::atoi(argv[++i]);
+            else if (std::strcmp(arg, "--seed") == 0 && hasValue)
+                options.seed = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+            else if (std::strcmp(arg, "--threads") == 0 && hasValue)
+                options.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+            else if (std::strcmp(arg, "--max-pieces") == 0 && hasValue)
+                options.maxPieces = std::atol(argv[++i]);
+            else if (std::strcmp(arg, "--csv") == 0 && hasValue)
+                options.csv = argv[++i];
+            else if (std::strcmp(arg, "--bench") == 0)
+                options.bench = true;
+            else if (std::strcmp(arg, "--json") == 0 && hasValue)
+                options.json = argv[++i];
+            else if (std::strcmp(arg, "--autoplay") == 0)
+                options.autoplay = true;
+            else if (std::strcmp(arg, "--fast") == 0)
+                options.fast = true;
+            else if (std::strcmp(arg, "--beam") == 0 && hasValue)
+                options.autoPlayer.beamWidth = std::atoi(argv[++i]);
+            else if (std::strcmp(arg, "--depth") == 0 && hasValue)
+                options.autoPlayer.depth = std::atoi(argv[++i]);
+            else if (std::strcmp(arg, "--profile") == 0 && hasValue)
+                options.profile = argv[++i];
+            else if (std::strcmp(arg, "--serve") == 0 && hasValue)
+                options.serve = argv[++i];
+            else if (std::strcmp(arg, "--max-sessions") == 0 && hasValue)
+                options.maxSessions = std::atoi(argv[++i]);
+            else if (std::strcmp(arg, "--loadgen") == 0 && hasValue)
+                options.loadgen = argv[++i];
+            else if (std::strcmp(arg, "--clients") == 0 && hasValue)
+                options.load.clients = std::atoi(argv[++i]);
+            else if (std::strcmp(arg, "--seconds") == 0 && hasValue)
+                options.load.seconds = std::atof(argv[++i]);
+            else if (std::strcmp(arg, "--broadcast") == 0 && hasValue)
+                options.broadcast = argv[++i];
+            else if (std::strcmp(arg, "--watch") == 0 && hasValue)
+                options.watch = argv[++i];
+            else if (std::strcmp(arg, "--watch-fps") == 0 && hasValue)
+                options.watchFps = std::atoi(argv[++i]);
+            else if (std::strcmp(arg, "--scores") == 0 && hasValue)
+                options.scoreFile = argv[++i];
+            else if (std::strcmp(arg, "--no-scores") == 0)
+                options.scoreFile = nullptr;
+            else if (std::strcmp(arg, "--stats") == 0)
+                options.stats = true;
+            else if (std::strcmp(arg, "--checkpoint") == 0 && hasValue)
+                options.checkpoint = argv[++i];
+            else if (std::strcmp(arg, "--fork") == 0 && hasValue)
+                options.fork = argv[++i];
+            else if (std::strcmp(arg, "--record") == 0 && hasValue)
+                options.recordDir = argv[++i];
+            else if (std::strcmp(arg, "--replay") == 0 && hasValue)
+            {
+                options.replayFirst = i + 1; // Every remaining argument is a replay file
+                break;
+            }
+            else if (std::strcmp(arg, "--randomizer") == 0 && hasValue)
+            {
+                const char *name = argv[++i];
+                if (std::strcmp(name, "uniform") == 0)
+                    options.randomizer = Randomizer::UNIFORM;
+                else if (std::strcmp(name, "bag") == 0)
+                    options.randomizer = Randomizer::BAG;
+                else
+                    return false;
+            }
+            else
+                return false;
+        }
+        return true;
+    }
+
+    // Runs headless self-play games and prints the summary
+    int runBatch(const Options &options)
+    {
+        BatchRunner runner([]
+                           { return std::unique_ptr<Policy>(new RandomPolicy()); },
+                           options.randomizer);
+        runner.run(options.batchGames, options.seed, options.threads, options.maxPieces);
+        runner.printSummary(std::cout);
+        if (options.csv != nullptr && !runner.writeResults(options.csv))
+        {
+            std::cerr << "Could not write " << options.csv << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    // Plays many games on from one checkpoint, after checking that a restored game has the same future
+    int runFork(const Options &options)
+    {
+        Checkpoint checkpoint;
+        Engine start;
+        if (!checkpoint.read(options.fork) || !start.restore(checkpoint))
+        {
+            std::cerr << options.fork << ": not a valid checkpoint\n";
+            return 1;
+        }
+        if (!Checkpoint::verifyFuture(start, options.seed, 4000))
+        {
+            std::cerr << options.fork << ": a restored copy of this game diverged from the original\n";
+            return 1;
+        }
+        std::cout << "Forking from score " << start.getScore() << ", " << start.getPiecesPlaced()
+                  << " pieces (restored game verified to replay identically)\n";
+
+        BatchRunner runner([]
+                           { return std::unique_ptr<Policy>(new RandomPolicy()); },
+                           start.getRandomizerMode());
+        runner.fork(start, options.batchGames > 0 ? options.batchGames : 1000, options.seed, options.threads, options.maxPieces);
+        runner.printSummary(std::cout);
+        if (options.csv != nullptr && !runner.writeResults(options.csv))
+        {
+            std::cerr << "Could not write " << options.csv << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    // Runs the microbenchmarks, printing a table and optionally writing JSON
+    int runBenchmarks(const Options &options)
+    {
+        Benchmark benchmark;
+        benchmark.runAll();
+        benchmark.print(std::cout);
+        if (options.json != nullptr && !benchmark.writeJson(options.json))
+        {
+            std::cerr << "Could not write " << options.json << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    // Hosts games on a Unix socket until interrupted, then prints the totals
+    int runServer(const Options &options)
+    {
+        GameServer::Settings settings;
+        settings.maxSessions = options.maxSessions;
+        settings.seed = options.seed;
+        settings.randomizer = options.randomizer;
+        GameServer server(settings);
+        if (!server.run(options.serve))
+            return 1;
+        server.printSummary(std::cout);
+        return 0;
+    }
+
+    // Load-tests a running server and prints the latency report
+    int runLoadGenerator(const Options &options)
+    {
+        LoadGenerator::Settings settings = options.load;
+        settings.seed = options.seed;
+        LoadGenerator generator(settings);
+        if (!generator.run(options.loadgen))
+        {
+            std::cerr << "Could not connect to " << options.loadgen << "\n";
+            return 1;
+        }
+        generator.printReport(std::cout);
+        return 0;
+    }
+
+    // Prints the lifetime statistics kept in the score file
+    int runStats(const Options &options)
+    {
+        if (options.scoreFile == nullptr)
+            return 1;
+        ScoreStore store;
+        if (!store.open(options.scoreFile))
+            return 1;
+        const ScoreStore::OpenStats &opened = store.getOpenStats();
+        store.printSummary(std::cout);
+        std::cout << "Score file: " << options.scoreFile << ", " << opened.replayed << " records after the last compaction";
+        if (opened.recovered)
+            std::cout << ", " << opened.droppedBytes << " bytes of an incomplete record dropped";
+        std::cout << "\n";
+        return 0;
+    }
+
+    // Verifies every replay file from argv[first] on and reports throughput
+    int runReplays(int argc, char *argv[], int first)
+    {
+        int failures = 0;
+        long frames = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = first; i < argc; ++i)
+        {
+            ReplayPlayer player;
+            if (!player.open(argv[i]))
+            {
+                std::cerr << argv[i] << ": cannot open\n";
+                failures++;
+                continue;
+            }
+            ReplayCheck check = player.verify();
+            frames += check.frames;
+            if (!check.ok)
+            {
+                std::cerr << argv[i] << ": " << check.error << " (score " << check.score << ", lines " << check.lines << ")\n";
+                failures++;
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        int replays = argc - first;
+        std::cout << replays - failures << "/" << replays << " replays verified in " << seconds << " s ("
+                  << replays / (seconds > 0 ? seconds : 1e-9) << " replays/s, "
+                  << frames / (seconds > 0 ? seconds : 1e-9) << " frames/s)\n";
+        return failures == 0 ? 0 : 1;
+    }
+}
 
 // Entry point of the program
-int main()
+int main(int argc, char *argv[])
 {
-    Game tetrisGame;  // Create a Game object
-    tetrisGame.run(); // Start the game loop
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (Profiler::ENABLED)
+        Profiler::install(options.profile); // Before any thread starts, so they all leave SIGUSR1 to the profiler
+
+    if (options.replayFirst > 0)
+        return runReplays(argc, argv, options.replayFirst); // Replay verification
+    if (options.bench)
+        return runBenchmarks(options); // Microbenchmarks
+    if (options.fork != nullptr)
+        return runFork(options); // Continuations of a saved game
+    if (options.batchGames > 0)
+        return runBatch(options); // Headless self-play
+    if (options.serve != nullptr)
+        return runServer(options); // Game server
+    if (options.loadgen != nullptr)
+        return runLoadGenerator(options); // Load test of a game server
+    if (options.stats)
+        return runStats(options); // Lifetime statistics
+    if (options.watch != nullptr)
+        return Spectator(options.watchFps).run(options.watch) ? 0 : 1; // Spectator
+
+    GameOptions gameOptions;
+    gameOptions.randomizer = options.randomizer;
+    gameOptions.recordDir = options.recordDir;
+    gameOptions.autoplay = options.autoplay;
+    gameOptions.fast = options.fast;
+    gameOptions.autoPlayer = options.autoPlayer;
+    gameOptions.threads = options.threads;
+    gameOptions.broadcast = options.broadcast;
+    gameOptions.scoreFile = options.scoreFile;
+    gameOptions.checkpointFile = options.checkpoint;
+    Game tetrisGame(gameOptions); // Create a Game object
+    tetrisGame.run();             // Start the game loop
 
     return 0; // Exit the program
 }
+
+#endif